@@ -27,6 +27,7 @@
 
 #include "rosidl_typesupport_fastrtps_cpp/message_type_support.h"
 
+#include "rmw_fastrtps_shared_cpp/generated_serialization.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 namespace rmw_fastrtps_cpp
@@ -50,7 +51,7 @@ protected:
 
 private:
   const message_type_support_callbacks_t * members_;
-  bool has_data_;
+  rmw_fastrtps_shared_cpp::GeneratedSerialization serialization_;
 };
 
 }  // namespace rmw_fastrtps_cpp
@@ -26,6 +26,8 @@ namespace rmw_fastrtps_cpp
 /**
  * The function returns `NULL` when either the node handle is `NULL` or when the
  * node handle is from a different rmw implementation.
+ * The participant is owned by the context of the node and shared with all the
+ * other nodes of that context created with the same domain id and security options.
  *
  * \return native FastRTPS participant handle if successful, otherwise `NULL`
  */
@@ -0,0 +1,46 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_CPP__GET_PAYLOAD_SIZING_STATS_HPP_
+#define RMW_FASTRTPS_CPP__GET_PAYLOAD_SIZING_STATS_HPP_
+
+#include "rmw/rmw.h"
+#include "rmw_fastrtps_shared_cpp/payload_sizing.hpp"
+#include "rmw_fastrtps_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_cpp
+{
+
+/// Get the counters of the payloads reserved by a publisher.
+/**
+ * The payloads of publishers of unbounded types are reserved for the largest of the recent
+ * samples, see RMW_FASTRTPS_PAYLOAD_SIZING_WINDOW.
+ * The difference between `reallocations_without_presizing` and `reallocations` is the
+ * number of payload reallocations avoided that way.
+ *
+ * \param publisher the publisher to get the counters of
+ * \param stats [out] the counters, all 0 if the payloads of the publisher are not presized
+ * \return RMW_RET_OK if successful, or
+ * \return RMW_RET_INVALID_ARGUMENT if the publisher handle is `NULL`, or
+ * \return RMW_RET_INCORRECT_RMW_IMPLEMENTATION if the publisher handle is from a different
+ *   rmw implementation
+ */
+RMW_FASTRTPS_CPP_PUBLIC
+rmw_ret_t
+get_payload_sizing_stats(
+  const rmw_publisher_t * publisher, rmw_fastrtps_shared_cpp::PayloadSizingStats & stats);
+
+}  // namespace rmw_fastrtps_cpp
+
+#endif  // RMW_FASTRTPS_CPP__GET_PAYLOAD_SIZING_STATS_HPP_
@@ -21,8 +21,10 @@
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
 #include "rmw_fastrtps_shared_cpp/guid_utils.hpp"
+#include "rmw_fastrtps_shared_cpp/history_memory_policy.hpp"
 #include "rmw_fastrtps_shared_cpp/names.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
+#include "rmw_fastrtps_shared_cpp/publish_mode.hpp"
 #include "rmw_fastrtps_shared_cpp/qos.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 
@@ -152,14 +154,31 @@ rmw_create_publisher(
   }
 
   if (!impl->leave_middleware_default_qos) {
-    publisherParam.qos.m_publishMode.kind = eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE;
-    publisherParam.historyMemoryPolicy =
-      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+    publisherParam.qos.m_publishMode.kind = rmw_fastrtps_shared_cpp::get_publish_mode(topic_name);
+    publisherParam.historyMemoryPolicy = rmw_fastrtps_shared_cpp::get_history_memory_policy(
+      topic_name, info->type_support_->is_bounded(), info->type_support_->m_typeSize);
+
+    // Grow the payloads of unbounded types to the recent high water mark at once
+    uint32_t window = rmw_fastrtps_shared_cpp::get_payload_sizing_window();
+    if (
+      window != 0 && !info->type_support_->is_bounded() &&
+      publisherParam.historyMemoryPolicy ==
+      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE)
+    {
+      info->payload_sizing_.reset(
+        new (std::nothrow) rmw_fastrtps_shared_cpp::PayloadSizing(
+          info->type_support_->m_typeSize, window));
+      if (!info->payload_sizing_) {
+        RMW_SET_ERROR_MSG("failed to allocate payload sizing");
+        goto fail;
+      }
+    }
   }
 
   publisherParam.topic.topicKind = eprosima::fastrtps::rtps::NO_KEY;
   publisherParam.topic.topicDataType = type_name;
   publisherParam.topic.topicName = _create_topic_name(qos_policies, ros_topic_prefix, topic_name);
+  publisherParam.qos.m_userData.setDataVec(impl->endpoint_user_data);
 
   // 1 Heartbeat every 10ms
   // publisherParam.times.heartbeatPeriod.seconds = 0;
@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include "fastcdr/FastBuffer.h"
 
 #include "rmw/error_handling.h"
@@ -20,6 +24,46 @@
 
 #include "./type_support_common.hpp"
 
+namespace
+{
+
+/// Return the type support for the given callbacks, creating it on first use.
+/**
+ * Type supports are stateless once built, so a single instance per message type is shared by
+ * every thread and kept until the process exits.
+ * As they are never removed, each thread remembers the ones it used, and only takes the mutex
+ * of the shared map the first time it uses a type.
+ */
+const MessageTypeSupport_cpp *
+get_cached_message_type_support(const message_type_support_callbacks_t * callbacks)
+{
+  using TypeSupportCache = std::unordered_map<
+    const message_type_support_callbacks_t *, const MessageTypeSupport_cpp *>;
+  thread_local TypeSupportCache thread_cache;
+  auto found = thread_cache.find(callbacks);
+  if (found != thread_cache.end()) {
+    return found->second;
+  }
+
+  static std::mutex mutex;
+  static std::unordered_map<
+    const message_type_support_callbacks_t *, std::unique_ptr<MessageTypeSupport_cpp>> cache;
+
+  const MessageTypeSupport_cpp * type_support;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto & tss = cache[callbacks];
+    if (!tss) {
+      tss.reset(new MessageTypeSupport_cpp(callbacks));
+    }
+    type_support = tss.get();
+  }
+  thread_cache.emplace(callbacks, type_support);
+  return type_support;
+}
+
+}  // namespace
+
 extern "C"
 {
 rmw_ret_t
@@ -40,7 +84,7 @@ rmw_serialize(
   }
 
   auto callbacks = static_cast<const message_type_support_callbacks_t *>(ts->data);
-  auto tss = new MessageTypeSupport_cpp(callbacks);
+  auto tss = get_cached_message_type_support(callbacks);
   auto data_length = tss->getEstimatedSerializedSize(ros_message, callbacks);
   if (serialized_message->buffer_capacity < data_length) {
     if (rmw_serialized_message_resize(serialized_message, data_length) != RMW_RET_OK) {
@@ -57,7 +101,6 @@ rmw_serialize(
   auto ret = tss->serializeROSmessage(ros_message, ser, callbacks);
   serialized_message->buffer_length = data_length;
   serialized_message->buffer_capacity = data_length;
-  delete tss;
   return ret == true ? RMW_RET_OK : RMW_RET_ERROR;
 }
 
@@ -79,24 +122,47 @@ rmw_deserialize(
   }
 
   auto callbacks = static_cast<const message_type_support_callbacks_t *>(ts->data);
-  auto tss = new MessageTypeSupport_cpp(callbacks);
+  auto tss = get_cached_message_type_support(callbacks);
   eprosima::fastcdr::FastBuffer buffer(
     reinterpret_cast<char *>(serialized_message->buffer), serialized_message->buffer_length);
   eprosima::fastcdr::Cdr deser(buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
     eprosima::fastcdr::Cdr::DDS_CDR);
 
   auto ret = tss->deserializeROSmessage(deser, ros_message, callbacks);
-  delete tss;
   return ret == true ? RMW_RET_OK : RMW_RET_ERROR;
 }
 
 rmw_ret_t
 rmw_get_serialized_message_size(
-  const rosidl_message_type_support_t * /*type_support*/,
-  const rosidl_message_bounds_t * /*message_bounds*/,
-  size_t * /*size*/)
+  const rosidl_message_type_support_t * type_support,
+  const rosidl_message_bounds_t * message_bounds,
+  size_t * size)
 {
-  RMW_SET_ERROR_MSG("unimplemented");
-  return RMW_RET_ERROR;
+  RMW_CHECK_ARGUMENT_FOR_NULL(type_support, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(size, RMW_RET_INVALID_ARGUMENT);
+  // Message bounds carry no information yet, only bounded types have a maximum size
+  (void)message_bounds;
+
+  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
+    type_support, RMW_FASTRTPS_CPP_TYPESUPPORT_C);
+  if (!ts) {
+    ts = get_message_typesupport_handle(
+      type_support, RMW_FASTRTPS_CPP_TYPESUPPORT_CPP);
+    if (!ts) {
+      RMW_SET_ERROR_MSG("type support not from this implementation");
+      return RMW_RET_ERROR;
+    }
+  }
+
+  auto callbacks = static_cast<const message_type_support_callbacks_t *>(ts->data);
+  auto tss = get_cached_message_type_support(callbacks);
+  if (!tss->is_bounded()) {
+    RMW_SET_ERROR_MSG("message type is unbounded, its serialized size has no maximum");
+    return RMW_RET_ERROR;
+  }
+
+  // Includes the encapsulation header, as serialized by rmw_serialize
+  *size = tss->m_typeSize;
+  return RMW_RET_OK;
 }
 }  // extern "C"
@@ -21,6 +21,7 @@
 
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/history_memory_policy.hpp"
 #include "rmw_fastrtps_shared_cpp/names.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 #include "rmw_fastrtps_shared_cpp/qos.hpp"
@@ -149,13 +150,14 @@ rmw_create_subscription(
   }
 
   if (!impl->leave_middleware_default_qos) {
-    subscriberParam.historyMemoryPolicy =
-      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+    subscriberParam.historyMemoryPolicy = rmw_fastrtps_shared_cpp::get_history_memory_policy(
+      topic_name, info->type_support_->is_bounded(), info->type_support_->m_typeSize);
   }
 
   subscriberParam.topic.topicKind = eprosima::fastrtps::rtps::NO_KEY;
   subscriberParam.topic.topicDataType = type_name;
   subscriberParam.topic.topicName = _create_topic_name(qos_policies, ros_topic_prefix, topic_name);
+  subscriberParam.qos.m_userData.setDataVec(impl->endpoint_user_data);
 
   if (!get_datareader_qos(*qos_policies, subscriberParam)) {
     RMW_SET_ERROR_MSG("failed to get datareader qos");
@@ -30,21 +30,7 @@ TypeSupport::TypeSupport()
 void TypeSupport::set_members(const message_type_support_callbacks_t * members)
 {
   members_ = members;
-
-  // Fully bound by default
-  max_size_bound_ = true;
-  auto data_size = static_cast<uint32_t>(members->max_serialized_size(max_size_bound_));
-
-  // A fully bound message of size 0 is an empty message
-  if (max_size_bound_ && (data_size == 0) ) {
-    has_data_ = false;
-    ++data_size;  // Dummy byte
-  } else {
-    has_data_ = true;
-  }
-
-  // Total size is encapsulation size + data size
-  m_typeSize = 4 + data_size;
+  m_typeSize = serialization_.init(members, max_size_bound_);
 }
 
 size_t TypeSupport::getEstimatedSerializedSize(const void * ros_message, const void * impl) const
@@ -53,56 +39,28 @@ size_t TypeSupport::getEstimatedSerializedSize(const void * ros_message, const v
     return m_typeSize;
   }
 
-  assert(ros_message);
   assert(impl);
 
   auto callbacks = static_cast<const message_type_support_callbacks_t *>(impl);
-
-  // Encapsulation size + message size
-  return 4 + callbacks->get_serialized_size(ros_message);
+  return serialization_.getEstimatedSerializedSize(callbacks, ros_message);
 }
 
 bool TypeSupport::serializeROSmessage(
   const void * ros_message, eprosima::fastcdr::Cdr & ser, const void * impl) const
 {
-  assert(ros_message);
   assert(impl);
 
-  // Serialize encapsulation
-  ser.serialize_encapsulation();
-
-  // If type is not empty, serialize message
-  if (has_data_) {
-    auto callbacks = static_cast<const message_type_support_callbacks_t *>(impl);
-    return callbacks->cdr_serialize(ros_message, ser);
-  }
-
-  // Otherwise, add a dummy byte
-  ser << (uint8_t)0;
-  return true;
+  auto callbacks = static_cast<const message_type_support_callbacks_t *>(impl);
+  return serialization_.serialize(callbacks, ros_message, ser);
 }
 
 bool TypeSupport::deserializeROSmessage(
   eprosima::fastcdr::Cdr & deser, void * ros_message, const void * impl) const
 {
-  assert(ros_message);
   assert(impl);
 
-  // Deserialize encapsulation.
-  deser.read_encapsulation();
-
-  // If type is not empty, deserialize message
-  if (has_data_) {
-    auto callbacks = static_cast<const message_type_support_callbacks_t *>(impl);
-    return callbacks->cdr_deserialize(deser, ros_message);
-  }
-
-  // Otherwise, consume dummy byte
-  uint8_t dump = 0;
-  deser >> dump;
-  (void)dump;
-
-  return true;
+  auto callbacks = static_cast<const message_type_support_callbacks_t *>(impl);
+  return serialization_.deserialize(callbacks, deser, ros_message);
 }
 
 MessageTypeSupport::MessageTypeSupport(const message_type_support_callbacks_t * members)
@@ -0,0 +1,60 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_DYNAMIC_CPP__GENERATEDMESSAGETYPESUPPORT_HPP_
+#define RMW_FASTRTPS_DYNAMIC_CPP__GENERATEDMESSAGETYPESUPPORT_HPP_
+
+#include <fastcdr/Cdr.h>
+
+#include <string>
+
+#include "rosidl_typesupport_fastrtps_cpp/message_type_support.h"
+
+#include "rmw_fastrtps_shared_cpp/generated_serialization.hpp"
+
+#include "TypeSupport.hpp"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+/**
+ * Message type support backed by the code generated by rosidl_typesupport_fastrtps_c/cpp.
+ *
+ * It produces the same CDR stream as MessageTypeSupport does for the introspection type
+ * support of the same type, which stays the key of the type in the TypeSupportRegistry.
+ */
+class GeneratedMessageTypeSupport : public BaseTypeSupport
+{
+public:
+  GeneratedMessageTypeSupport(
+    const message_type_support_callbacks_t * callbacks,
+    const std::string & type_name,
+    const void * ros_type_support);
+
+  size_t getEstimatedSerializedSize(const void * ros_message, const void * impl) const override;
+
+  bool serializeROSmessage(
+    const void * ros_message, eprosima::fastcdr::Cdr & ser, const void * impl) const override;
+
+  bool deserializeROSmessage(
+    eprosima::fastcdr::Cdr & deser, void * ros_message, const void * impl) const override;
+
+private:
+  const message_type_support_callbacks_t * callbacks_;
+  rmw_fastrtps_shared_cpp::GeneratedSerialization serialization_;
+};
+
+}  // namespace rmw_fastrtps_dynamic_cpp
+
+#endif  // RMW_FASTRTPS_DYNAMIC_CPP__GENERATEDMESSAGETYPESUPPORT_HPP_
@@ -38,6 +38,7 @@ MessageTypeSupport<MembersType>::MessageTypeSupport(
 {
   assert(members);
   this->members_ = members;
+  this->compileSerializationPlan();
 
   std::ostringstream ss;
   std::string message_namespace(this->members_->message_namespace_);
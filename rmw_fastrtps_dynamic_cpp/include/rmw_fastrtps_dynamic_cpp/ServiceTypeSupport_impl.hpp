@@ -36,6 +36,7 @@ RequestTypeSupport<ServiceMembersType, MessageMembersType>::RequestTypeSupport(
 {
   assert(members);
   this->members_ = members->request_members_;
+  this->compileSerializationPlan();
 
   std::ostringstream ss;
   std::string service_namespace(members->service_namespace_);
@@ -66,6 +67,7 @@ ResponseTypeSupport<ServiceMembersType, MessageMembersType>::ResponseTypeSupport
 {
   assert(members);
   this->members_ = members->response_members_;
+  this->compileSerializationPlan();
 
   std::ostringstream ss;
   std::string service_namespace(members->service_namespace_);
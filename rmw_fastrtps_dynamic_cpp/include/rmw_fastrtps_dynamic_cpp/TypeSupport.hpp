@@ -22,8 +22,15 @@
 
 #include <fastcdr/FastBuffer.h>
 #include <fastcdr/Cdr.h>
+#include <fastcdr/exceptions/NotEnoughMemoryException.h>
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include "rcutils/logging_macros.h"
 
@@ -41,16 +48,36 @@
 
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
+#include "rmw_fastrtps_dynamic_cpp/worker_pool.hpp"
+
 namespace rmw_fastrtps_dynamic_cpp
 {
 
+/// Check that a CDR buffer holds a number of bytes read from the wire, before allocating them.
+/**
+ * \param deser CDR stream positioned at the start of the bytes.
+ * \param size number of bytes.
+ * \throw eprosima::fastcdr::exception::NotEnoughMemoryException if the buffer is too short,
+ *   as Fast CDR does when reading past its end.
+ */
+inline void check_remaining_size(eprosima::fastcdr::Cdr & deser, size_t size)
+{
+  eprosima::fastcdr::Cdr::state state = deser.getState();
+  const bool fits = deser.jump(size);
+  deser.setState(state);
+  if (!fits) {
+    using eprosima::fastcdr::exception::NotEnoughMemoryException;
+    throw NotEnoughMemoryException(NotEnoughMemoryException::NOT_ENOUGH_MEMORY_MESSAGE_DEFAULT);
+  }
+}
+
 // Helper class that uses template specialization to read/write string types to/from a
 // eprosima::fastcdr::Cdr
 template<typename MembersType>
 struct StringHelper;
 
-// For C introspection typesupport we create intermediate instances of std::string so that
-// eprosima::fastcdr::Cdr can handle the string properly.
+// For C introspection typesupport strings are written to and read from the CDR buffer
+// directly out of the rosidl_generator_c__String buffers, without intermediate std::string.
 template<>
 struct StringHelper<rosidl_typesupport_introspection_c__MessageMembers>
 {
@@ -77,35 +104,57 @@ struct StringHelper<rosidl_typesupport_introspection_c__MessageMembers>
     return current_alignment + strlen(c_string->data) + 1;
   }
 
-  static std::string convert_to_std_string(void * data)
+  /// Serialize a string, including its null terminator, as CDR does for std::string.
+  /**
+   * \param ser CDR stream to serialize into.
+   * \param c_string string to serialize.
+   * \param upper_bound maximum length of the string, 0 if it is unbounded.
+   */
+  static void serialize(
+    eprosima::fastcdr::Cdr & ser, const rosidl_generator_c__String & c_string,
+    size_t upper_bound = 0)
   {
-    auto c_string = static_cast<rosidl_generator_c__String *>(data);
-    if (!c_string) {
-      RCUTILS_LOG_ERROR_NAMED(
-        "rmw_fastrtps_dynamic_cpp",
-        "Failed to cast data as rosidl_generator_c__String");
-      return "";
-    }
-    if (!c_string->data) {
+    if (!c_string.data) {
       RCUTILS_LOG_ERROR_NAMED(
         "rmw_fastrtps_dynamic_cpp",
         "rosidl_generator_c_String had invalid data");
-      return "";
+      ser << static_cast<uint32_t>(1u);
+      ser << '\0';
+      return;
     }
-    return std::string(c_string->data);
-  }
-
-  static std::string convert_to_std_string(rosidl_generator_c__String & data)
-  {
-    return std::string(data.data);
+    const size_t length = strlen(c_string.data);
+    // Control maximum length.
+    if (upper_bound && length > upper_bound + 1) {
+      throw std::runtime_error("string overcomes the maximum length");
+    }
+    ser << static_cast<uint32_t>(length + 1);
+    ser.serializeArray(c_string.data, length + 1);
   }
 
+  /// Deserialize a string into the existing buffer, which only grows when it is too small.
   static void assign(eprosima::fastcdr::Cdr & deser, void * field, bool)
   {
-    std::string str;
-    deser >> str;
-    rosidl_generator_c__String * c_str = static_cast<rosidl_generator_c__String *>(field);
-    rosidl_generator_c__String__assign(c_str, str.c_str());
+    auto c_string = static_cast<rosidl_generator_c__String *>(field);
+    uint32_t length = 0;
+    deser >> length;
+    check_remaining_size(deser, length);
+    // Room for a null terminator even if the sender did not include one
+    const size_t capacity = static_cast<size_t>(length) + 1;
+    if (!c_string->data || c_string->capacity < capacity) {
+      char * data = static_cast<char *>(realloc(c_string->data, capacity));
+      if (!data) {
+        throw std::runtime_error("unable to allocate rosidl_generator_c__String");
+      }
+      c_string->data = data;
+      c_string->capacity = capacity;
+    }
+    if (length) {
+      deser.deserializeArray(c_string->data, length);
+    }
+    // The length normally includes the null terminator, but not every sender adds one
+    const size_t size = (length && c_string->data[length - 1] == '\0') ? length - 1 : length;
+    c_string->data[size] = '\0';
+    c_string->size = size;
   }
 };
 
@@ -120,21 +169,46 @@ struct StringHelper<rosidl_typesupport_introspection_cpp::MessageMembers>
     return *(static_cast<std::string *>(data));
   }
 
+  /// Deserialize a string in place, keeping its capacity unlike Fast CDR does.
   static void assign(eprosima::fastcdr::Cdr & deser, void * field, bool call_new)
   {
     std::string & str = *(std::string *)field;
     if (call_new) {
       new(&str) std::string;
     }
-    deser >> str;
+    uint32_t length = 0;
+    deser >> length;
+    check_remaining_size(deser, length);
+    str.resize(length);
+    if (length) {
+      deser.deserializeArray(&str[0], length);
+      // The length normally includes the null terminator, but not every sender adds one
+      if (str[length - 1] == '\0') {
+        str.resize(length - 1);
+      }
+    }
   }
 };
 
+/**
+ * Type registered in the participant for a type name, shared by the C and C++ type supports.
+ *
+ * The type support of the publisher or subscription, given by the `impl` of each sample,
+ * does the actual work.
+ * serialize(), deserialize() and getSerializedSizeProvider() call it directly, rather than
+ * through the ROS message methods of the proxy.
+ */
 class TypeSupportProxy : public rmw_fastrtps_shared_cpp::TypeSupport
 {
 public:
   explicit TypeSupportProxy(rmw_fastrtps_shared_cpp::TypeSupport * inner_type);
 
+  bool serialize(void * data, eprosima::fastrtps::rtps::SerializedPayload_t * payload) override;
+
+  bool deserialize(eprosima::fastrtps::rtps::SerializedPayload_t * payload, void * data) override;
+
+  std::function<uint32_t()> getSerializedSizeProvider(void * data) override;
+
   size_t getEstimatedSerializedSize(const void * ros_message, const void * impl) const override;
 
   bool serializeROSmessage(
@@ -162,6 +236,66 @@ private:
   const void * ros_type_support_;
 };
 
+/**
+ * One step of a compiled serialization plan.
+ *
+ * A step either transfers `count` adjacent primitives of `primitive_size` bytes at once,
+ * or interprets a single member through the introspection data.
+ */
+template<typename MembersType>
+struct SerializationStep
+{
+  using MemberType = typename std::remove_cv<
+    typename std::remove_pointer<decltype(MembersType::members_)>::type>::type;
+
+  // Offset of the field from the start of the top level message.
+  size_t offset;
+  // Member to interpret, or nullptr for a bulk transfer of primitives.
+  const MemberType * member;
+  size_t primitive_size;
+  size_t count;
+};
+
+/**
+ * Memory layout of a message type, computed once per type.
+ */
+struct MembersLayout
+{
+  // Largest alignment of a member, which is the alignment of the message itself.
+  size_t max_align;
+  // Distance between two consecutive messages of this type in an array.
+  size_t stride;
+  // Whether the message has no strings or sequences at all, recursively.
+  bool is_fixed_size;
+  // Largest CDR alignment of a primitive in a fixed size message, 0 otherwise.
+  size_t cdr_align;
+  // Serialized size of a fixed size message starting i bytes past a multiple of cdr_align.
+  size_t cdr_sizes[8];
+};
+
+/**
+ * Primitive sequences of a C message pointing into the CDR buffer instead of owning a copy.
+ *
+ * Only used while the current thread deserializes a loaned message, see
+ * current_sequence_views().
+ */
+struct SequenceViews
+{
+  // Start of the CDR stream, right after the encapsulation, which CDR alignment is relative to.
+  const char * cdr_origin;
+  // Smallest sequence, in bytes, deserialized as a view.
+  size_t min_size;
+  // Sequences pointing into the CDR buffer, to be detached before the message is finalized.
+  std::vector<void *> sequences;
+};
+
+/// Views to use for the message deserialized by this thread, nullptr to copy every sequence.
+inline SequenceViews *& current_sequence_views()
+{
+  static thread_local SequenceViews * views = nullptr;
+  return views;
+}
+
 template<typename MembersType>
 class TypeSupport : public BaseTypeSupport
 {
@@ -174,14 +308,70 @@ public:
   bool deserializeROSmessage(
     eprosima::fastcdr::Cdr & deser, void * ros_message, const void * impl) const override;
 
+  /// Whether messages are copied to and from CDR with a single memcpy.
+  /**
+   * That is the case when the message only holds primitives and fixed size arrays of them,
+   * and its memory layout matches the CDR one, padding included.
+   * The copy is used when the CDR stream has the endianness of the host.
+   */
+  bool is_plain() const
+  {
+    return plain_size_ != 0;
+  }
+
 protected:
   explicit TypeSupport(const void * ros_type_support);
 
   size_t calculateMaxSerializedSize(const MembersType * members, size_t current_alignment);
 
+  /**
+   * Flatten members_ into plan_, must be called once members_ is set.
+   */
+  void compileSerializationPlan();
+
   const MembersType * members_;
 
 private:
+  using MemberType = typename SerializationStep<MembersType>::MemberType;
+
+  void compileSerializationPlan(const MembersType * members, size_t base_offset);
+
+  const MembersLayout & compileLayout(const MembersType * members);
+
+  const MembersLayout & getLayout(const MembersType * members) const;
+
+  void serializeMember(
+    eprosima::fastcdr::Cdr & ser,
+    const MemberType * member,
+    void * field) const;
+
+  void deserializeMember(
+    eprosima::fastcdr::Cdr & deser,
+    const MemberType * member,
+    void * field,
+    bool call_new) const;
+
+  bool deserializeArrayInParallel(
+    eprosima::fastcdr::Cdr & deser,
+    const MembersType * members,
+    void * array,
+    size_t count,
+    bool call_new) const;
+
+  size_t getMemberEstimatedSerializedSize(
+    const MemberType * member,
+    void * field,
+    size_t current_alignment) const;
+
+  // Built once per type, interpreted for every message.
+  std::vector<SerializationStep<MembersType>> plan_;
+
+  // Layout of members_ and of every message type nested in it.
+  std::unordered_map<const MembersType *, MembersLayout> layouts_;
+
+  // Serialized size of a plain message, without encapsulation, 0 if the type is not plain.
+  size_t plain_size_ = 0;
+
   size_t getEstimatedSerializedSize(
     const MembersType * members,
     const void * ros_message,
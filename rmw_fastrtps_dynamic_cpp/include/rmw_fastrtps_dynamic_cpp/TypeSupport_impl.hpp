@@ -17,14 +17,18 @@
 
 #include <fastcdr/FastBuffer.h>
 #include <fastcdr/Cdr.h>
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <exception>
+#include <mutex>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "rmw_fastrtps_dynamic_cpp/TypeSupport.hpp"
 #include "rmw_fastrtps_dynamic_cpp/macros.hpp"
-#include "rosidl_typesupport_fastrtps_c/wstring_conversion.hpp"
-#include "rosidl_typesupport_fastrtps_cpp/wstring_conversion.hpp"
+#include "rmw_fastrtps_shared_cpp/byte_swap.hpp"
 #include "rosidl_typesupport_introspection_cpp/field_types.hpp"
 #include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
 #include "rosidl_typesupport_introspection_cpp/service_introspection.hpp"
@@ -107,6 +111,51 @@ rosidl_generator_c__void__Sequence__fini(rosidl_generator_c__void__Sequence * se
   }
 }
 
+/**
+ * Resize a C sequence for deserialization, keeping its buffer when it is large enough.
+ *
+ * Elements past the new size stay allocated (the rosidl fini functions release up to the
+ * capacity), so a sequence only ever grows and taking into the same message again does not
+ * allocate.
+ * When growing, the new elements are zero-filled and then set up by `init_element`.
+ * \param sequence any rosidl C sequence (data, size, capacity)
+ * \param size the new number of valid elements
+ * \param element_size the size of one element in bytes
+ * \param init_element callable taking a `void *` to a new element, returning false on failure
+ * \return false if memory could not be allocated, true otherwise
+ */
+template<typename SequenceT, typename InitElementT>
+bool resize_c_sequence(
+  SequenceT * sequence, size_t size, size_t element_size, InitElementT init_element)
+{
+  if (size <= sequence->capacity) {
+    sequence->size = size;
+    return true;
+  }
+  void * data = realloc(sequence->data, size * element_size);
+  if (!data) {
+    return false;
+  }
+  auto bytes = static_cast<char *>(data);
+  memset(bytes + sequence->capacity * element_size, 0, (size - sequence->capacity) * element_size);
+  const size_t old_capacity = sequence->capacity;
+  sequence->data = static_cast<decltype(sequence->data)>(data);
+  sequence->size = size;
+  sequence->capacity = size;
+  for (size_t i = old_capacity; i < size; ++i) {
+    if (!init_element(bytes + i * element_size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template<typename SequenceT>
+bool resize_c_sequence(SequenceT * sequence, size_t size, size_t element_size)
+{
+  return resize_c_sequence(sequence, size, element_size, [](void *) {return true;});
+}
+
 template<typename MembersType>
 TypeSupport<MembersType>::TypeSupport(const void * ros_type_support)
 : BaseTypeSupport(ros_type_support)
@@ -115,6 +164,160 @@ TypeSupport<MembersType>::TypeSupport(const void * ros_type_support)
   max_size_bound_ = false;
 }
 
+// Size of a primitive whose CDR representation is a plain copy of its memory, 0 otherwise.
+inline size_t plain_primitive_size(uint8_t type_id)
+{
+  switch (type_id) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+      return 1;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+      return 2;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+      return 4;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+      return 8;
+    default:
+      // bools are normalized, strings and sequences are not stored inline
+      return 0;
+  }
+}
+
+template<typename MembersType>
+void TypeSupport<MembersType>::compileSerializationPlan()
+{
+  plan_.clear();
+  layouts_.clear();
+  plain_size_ = 0;
+  compileLayout(members_);
+  compileSerializationPlan(members_, 0);
+
+  // The message is plain when it only holds primitives stored exactly where CDR puts them,
+  // counting from the end of the encapsulation, padding included.
+  size_t cdr_offset = 0;
+  for (const auto & step : plan_) {
+    if (step.member) {
+      return;
+    }
+    cdr_offset += eprosima::fastcdr::Cdr::alignment(cdr_offset, step.primitive_size);
+    if (cdr_offset != step.offset) {
+      return;
+    }
+    cdr_offset += step.primitive_size * step.count;
+  }
+  plain_size_ = cdr_offset;
+}
+
+template<typename MembersType>
+const MembersLayout & TypeSupport<MembersType>::compileLayout(const MembersType * members)
+{
+  auto it = layouts_.find(members);
+  if (it != layouts_.end()) {
+    return it->second;
+  }
+
+  MembersLayout layout{};
+  layout.max_align = calculateMaxAlign(members);
+  layout.stride = members->size_of_;
+  if (layout.max_align > 1) {
+    layout.stride = (layout.stride + layout.max_align - 1) & ~(layout.max_align - 1);
+  }
+  layout.is_fixed_size = true;
+  layout.cdr_align = 1;
+
+  for (uint32_t i = 0; i < members->member_count_; ++i) {
+    const auto & member = members->members_[i];
+    bool is_fixed_size = true;
+    size_t cdr_align = std::max<size_t>(plain_primitive_size(member.type_id_), 1);
+    if (member.is_array_ && (!member.array_size_ || member.is_upper_bound_)) {
+      is_fixed_size = false;
+    }
+    switch (member.type_id_) {
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
+        is_fixed_size = false;
+        break;
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
+        {
+          const MembersLayout & sub_layout =
+            compileLayout(static_cast<const MembersType *>(member.members_->data));
+          is_fixed_size = is_fixed_size && sub_layout.is_fixed_size;
+          cdr_align = sub_layout.cdr_align;
+        }
+        break;
+      default:
+        break;
+    }
+    layout.is_fixed_size = layout.is_fixed_size && is_fixed_size;
+    layout.cdr_align = std::max(layout.cdr_align, cdr_align);
+  }
+
+  if (layout.is_fixed_size) {
+    for (size_t i = 0; i < layout.cdr_align; ++i) {
+      layout.cdr_sizes[i] = calculateMaxSerializedSize(members, i);
+    }
+  } else {
+    layout.cdr_align = 0;
+  }
+
+  return layouts_[members] = layout;
+}
+
+template<typename MembersType>
+const MembersLayout & TypeSupport<MembersType>::getLayout(const MembersType * members) const
+{
+  auto it = layouts_.find(members);
+  // every message type reachable from members_ was laid out when the typesupport was created
+  assert(it != layouts_.end());
+  return it->second;
+}
+
+template<typename MembersType>
+void TypeSupport<MembersType>::compileSerializationPlan(
+  const MembersType * members, size_t base_offset)
+{
+  for (uint32_t i = 0; i < members->member_count_; ++i) {
+    const auto member = members->members_ + i;
+    const size_t offset = base_offset + member->offset_;
+
+    if (member->type_id_ == ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE &&
+      !member->is_array_)
+    {
+      // A nested message is laid out inline, flatten it into the parent plan
+      auto sub_members = static_cast<const MembersType *>(member->members_->data);
+      compileSerializationPlan(sub_members, offset);
+      continue;
+    }
+
+    const size_t primitive_size = plain_primitive_size(member->type_id_);
+    const bool is_fixed = !member->is_array_ || (member->array_size_ && !member->is_upper_bound_);
+    if (primitive_size == 0 || !is_fixed) {
+      plan_.push_back({offset, member, 0, 0});
+      continue;
+    }
+
+    const size_t count = member->is_array_ ? member->array_size_ : 1;
+    if (!plan_.empty()) {
+      auto & previous = plan_.back();
+      // Fuse with the previous run if the fields are contiguous, CDR adds no padding then
+      if (previous.member == nullptr && previous.primitive_size == primitive_size &&
+        previous.offset + previous.primitive_size * previous.count == offset)
+      {
+        previous.count += count;
+        continue;
+      }
+    }
+    plan_.push_back({offset, nullptr, primitive_size, count});
+  }
+}
+
 static inline void *
 align_(size_t __align, void * & __ptr) noexcept
 {
@@ -208,6 +411,77 @@ static size_t calculateMaxAlign(const MembersType * members)
   return max_align;
 }
 
+// Wide strings are sent as their number of characters followed by one 4 byte code unit per
+// character. They are widened and narrowed in small chunks on the stack, so that neither
+// std::wstring temporaries nor per character serialize calls are needed.
+constexpr size_t wstring_chunk_size = 64;
+
+template<typename CharT>
+inline void serialize_wstring(eprosima::fastcdr::Cdr & ser, const CharT * data, size_t size)
+{
+  ser << static_cast<uint32_t>(size);
+  uint32_t chunk[wstring_chunk_size];
+  while (size > 0) {
+    const size_t count = std::min(size, wstring_chunk_size);
+    std::copy(data, data + count, chunk);
+    ser.serializeArray(chunk, count);
+    data += count;
+    size -= count;
+  }
+}
+
+template<typename CharT>
+inline void deserialize_wstring_characters(
+  eprosima::fastcdr::Cdr & deser, CharT * data, size_t size)
+{
+  uint32_t chunk[wstring_chunk_size];
+  while (size > 0) {
+    const size_t count = std::min(size, wstring_chunk_size);
+    deser.deserializeArray(chunk, count);
+    for (size_t i = 0; i < count; ++i) {
+      data[i] = static_cast<CharT>(chunk[i]);
+    }
+    data += count;
+    size -= count;
+  }
+}
+
+inline void serialize_wstring(eprosima::fastcdr::Cdr & ser, const std::u16string & u16str)
+{
+  serialize_wstring(ser, u16str.data(), u16str.size());
+}
+
+inline void serialize_wstring(
+  eprosima::fastcdr::Cdr & ser, const rosidl_generator_c__U16String & u16str)
+{
+  serialize_wstring(ser, u16str.data, u16str.data ? u16str.size : 0);
+}
+
+inline void deserialize_wstring(eprosima::fastcdr::Cdr & deser, std::u16string & u16str)
+{
+  uint32_t size = 0;
+  deser >> size;
+  u16str.resize(size);
+  deserialize_wstring_characters(deser, &u16str[0], size);
+}
+
+inline void deserialize_wstring(
+  eprosima::fastcdr::Cdr & deser, rosidl_generator_c__U16String & u16str)
+{
+  uint32_t size = 0;
+  deser >> size;
+  // Only reallocate when the current buffer cannot hold the string and its terminator
+  if (!u16str.data || u16str.capacity < size + 1u) {
+    if (!rosidl_generator_c__U16String__resize(&u16str, size)) {
+      throw std::runtime_error("unable to resize rosidl_generator_c__U16String");
+    }
+  } else {
+    u16str.size = size;
+    u16str.data[size] = 0;
+  }
+  deserialize_wstring_characters(deser, u16str.data, size);
+}
+
 // C++ specialization
 template<typename T>
 void serialize_field(
@@ -232,11 +506,8 @@ void serialize_field<std::wstring>(
   void * field,
   eprosima::fastcdr::Cdr & ser)
 {
-  std::wstring wstr;
   if (!member->is_array_) {
-    auto u16str = static_cast<std::u16string *>(field);
-    rosidl_typesupport_fastrtps_cpp::u16string_to_wstring(*u16str, wstr);
-    ser << wstr;
+    serialize_wstring(ser, *static_cast<std::u16string *>(field));
   } else {
     size_t size;
     if (member->array_size_ && !member->is_upper_bound_) {
@@ -247,9 +518,7 @@ void serialize_field<std::wstring>(
     }
     for (size_t i = 0; i < size; ++i) {
       const void * element = member->get_const_function(field, i);
-      auto u16str = static_cast<const std::u16string *>(element);
-      rosidl_typesupport_fastrtps_cpp::u16string_to_wstring(*u16str, wstr);
-      ser << wstr;
+      serialize_wstring(ser, *static_cast<const std::u16string *>(element));
     }
   }
 }
@@ -280,33 +549,19 @@ void serialize_field<std::string>(
 {
   using CStringHelper = StringHelper<rosidl_typesupport_introspection_c__MessageMembers>;
   if (!member->is_array_) {
-    auto && str = CStringHelper::convert_to_std_string(field);
-    // Control maximum length.
-    if (member->string_upper_bound_ && str.length() > member->string_upper_bound_ + 1) {
-      throw std::runtime_error("string overcomes the maximum length");
+    CStringHelper::serialize(
+      ser, *static_cast<rosidl_generator_c__String *>(field), member->string_upper_bound_);
+  } else if (member->array_size_ && !member->is_upper_bound_) {
+    auto string_field = static_cast<rosidl_generator_c__String *>(field);
+    for (size_t i = 0; i < member->array_size_; ++i) {
+      CStringHelper::serialize(ser, string_field[i]);
     }
-    ser << str;
   } else {
-    // First, cast field to rosidl_generator_c
-    // Then convert to a std::string using StringHelper and serialize the std::string
-    if (member->array_size_ && !member->is_upper_bound_) {
-      // tmpstring is defined here and not below to avoid
-      // memory allocation in every iteration of the for loop
-      std::string tmpstring;
-      auto string_field = static_cast<rosidl_generator_c__String *>(field);
-      for (size_t i = 0; i < member->array_size_; ++i) {
-        tmpstring = string_field[i].data;
-        ser.serialize(tmpstring);
-      }
-    } else {
-      auto & string_sequence_field =
-        *reinterpret_cast<rosidl_generator_c__String__Sequence *>(field);
-      std::vector<std::string> cpp_string_vector;
-      for (size_t i = 0; i < string_sequence_field.size; ++i) {
-        cpp_string_vector.push_back(
-          CStringHelper::convert_to_std_string(string_sequence_field.data[i]));
-      }
-      ser << cpp_string_vector;
+    auto & string_sequence_field =
+      *reinterpret_cast<rosidl_generator_c__String__Sequence *>(field);
+    ser << static_cast<uint32_t>(string_sequence_field.size);
+    for (size_t i = 0; i < string_sequence_field.size; ++i) {
+      CStringHelper::serialize(ser, string_sequence_field.data[i]);
     }
   }
 }
@@ -318,26 +573,22 @@ void serialize_field<std::wstring>(
   void * field,
   eprosima::fastcdr::Cdr & ser)
 {
-  std::wstring wstr;
   if (!member->is_array_) {
-    auto u16str = static_cast<rosidl_generator_c__U16String *>(field);
-    rosidl_typesupport_fastrtps_c::u16string_to_wstring(*u16str, wstr);
-    ser << wstr;
+    serialize_wstring(ser, *static_cast<rosidl_generator_c__U16String *>(field));
   } else if (member->array_size_ && !member->is_upper_bound_) {
     auto array = static_cast<rosidl_generator_c__U16String *>(field);
     for (size_t i = 0; i < member->array_size_; ++i) {
-      rosidl_typesupport_fastrtps_c::u16string_to_wstring(array[i], wstr);
-      ser << wstr;
+      serialize_wstring(ser, array[i]);
     }
   } else {
     auto sequence = static_cast<rosidl_generator_c__U16String__Sequence *>(field);
     ser << static_cast<uint32_t>(sequence->size);
     for (size_t i = 0; i < sequence->size; ++i) {
-      rosidl_typesupport_fastrtps_c::u16string_to_wstring(sequence->data[i], wstr);
-      ser << wstr;
+      serialize_wstring(ser, sequence->data[i]);
     }
   }
 }
+
 inline
 size_t get_array_size_and_assign_field(
   const rosidl_typesupport_introspection_cpp::MessageMember * member,
@@ -383,90 +634,99 @@ bool TypeSupport<MembersType>::serializeROSmessage(
   for (uint32_t i = 0; i < members->member_count_; ++i) {
     const auto member = members->members_ + i;
     void * field = const_cast<char *>(static_cast<const char *>(ros_message)) + member->offset_;
-    switch (member->type_id_) {
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
+    serializeMember(ser, member, field);
+  }
+
+  return true;
+}
+
+template<typename MembersType>
+void TypeSupport<MembersType>::serializeMember(
+  eprosima::fastcdr::Cdr & ser,
+  const MemberType * member,
+  void * field) const
+{
+  switch (member->type_id_) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
+      if (!member->is_array_) {
+        // don't cast to bool here because if the bool is
+        // uninitialized the random value can't be deserialized
+        ser << (*static_cast<uint8_t *>(field) ? true : false);
+      } else {
+        serialize_field<bool>(member, field, ser);
+      }
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+      serialize_field<uint8_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+      serialize_field<char>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+      serialize_field<float>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+      serialize_field<double>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+      serialize_field<int16_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+      serialize_field<uint16_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+      serialize_field<int32_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+      serialize_field<uint32_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+      serialize_field<int64_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+      serialize_field<uint64_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
+      serialize_field<std::string>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
+      serialize_field<std::wstring>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
+      {
+        auto sub_members = static_cast<const MembersType *>(member->members_->data);
         if (!member->is_array_) {
-          // don't cast to bool here because if the bool is
-          // uninitialized the random value can't be deserialized
-          ser << (*static_cast<uint8_t *>(field) ? true : false);
+          serializeROSmessage(ser, sub_members, field);
         } else {
-          serialize_field<bool>(member, field, ser);
-        }
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
-        serialize_field<uint8_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
-        serialize_field<char>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
-        serialize_field<float>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
-        serialize_field<double>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
-        serialize_field<int16_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
-        serialize_field<uint16_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
-        serialize_field<int32_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
-        serialize_field<uint32_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
-        serialize_field<int64_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
-        serialize_field<uint64_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
-        serialize_field<std::string>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
-        serialize_field<std::wstring>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
-        {
-          auto sub_members = static_cast<const MembersType *>(member->members_->data);
-          if (!member->is_array_) {
-            serializeROSmessage(ser, sub_members, field);
+          void * subros_message = nullptr;
+          size_t array_size = 0;
+          size_t sub_members_size = sub_members->size_of_;
+          const MembersLayout & sub_layout = getLayout(sub_members);
+          size_t max_align = sub_layout.max_align;
+
+          if (member->array_size_ && !member->is_upper_bound_) {
+            subros_message = field;
+            array_size = member->array_size_;
           } else {
-            void * subros_message = nullptr;
-            size_t array_size = 0;
-            size_t sub_members_size = sub_members->size_of_;
-            size_t max_align = calculateMaxAlign(sub_members);
-
-            if (member->array_size_ && !member->is_upper_bound_) {
-              subros_message = field;
-              array_size = member->array_size_;
-            } else {
-              array_size = get_array_size_and_assign_field(
-                member, field, subros_message, sub_members_size, max_align);
-
-              // Serialize length
-              ser << (uint32_t)array_size;
-            }
+            array_size = get_array_size_and_assign_field(
+              member, field, subros_message, sub_members_size, max_align);
 
-            for (size_t index = 0; index < array_size; ++index) {
-              serializeROSmessage(ser, sub_members, subros_message);
-              subros_message = static_cast<char *>(subros_message) + sub_members_size;
-              subros_message = align_(max_align, subros_message);
-            }
+            // Serialize length
+            ser << (uint32_t)array_size;
+          }
+
+          for (size_t index = 0; index < array_size; ++index) {
+            serializeROSmessage(ser, sub_members, subros_message);
+            subros_message = static_cast<char *>(subros_message) + sub_layout.stride;
           }
         }
-        break;
-      default:
-        throw std::runtime_error("unknown type");
-    }
+      }
+      break;
+    default:
+      throw std::runtime_error("unknown type");
   }
-
-  return true;
 }
 
 // C++ specialization
@@ -645,85 +905,125 @@ size_t TypeSupport<MembersType>::getEstimatedSerializedSize(
   for (uint32_t i = 0; i < members->member_count_; ++i) {
     const auto member = members->members_ + i;
     void * field = const_cast<char *>(static_cast<const char *>(ros_message)) + member->offset_;
-    switch (member->type_id_) {
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
-        current_alignment = next_field_align<bool>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
-        current_alignment = next_field_align<uint8_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
-        current_alignment = next_field_align<char>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
-        current_alignment = next_field_align<float>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
-        current_alignment = next_field_align<double>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
-        current_alignment = next_field_align<int16_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
-        current_alignment = next_field_align<uint16_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
-        current_alignment = next_field_align<int32_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
-        current_alignment = next_field_align<uint32_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
-        current_alignment = next_field_align<int64_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
-        current_alignment = next_field_align<uint64_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
-        current_alignment = next_field_align_string<std::string>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
-        current_alignment = next_field_align_string<std::wstring>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
-        {
-          auto sub_members = static_cast<const MembersType *>(member->members_->data);
-          if (!member->is_array_) {
-            current_alignment += getEstimatedSerializedSize(sub_members, field, current_alignment);
+    current_alignment = getMemberEstimatedSerializedSize(member, field, current_alignment);
+  }
+
+  return current_alignment - initial_alignment;
+}
+
+template<typename MembersType>
+size_t TypeSupport<MembersType>::getMemberEstimatedSerializedSize(
+  const MemberType * member,
+  void * field,
+  size_t current_alignment) const
+{
+  switch (member->type_id_) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
+      current_alignment = next_field_align<bool>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+      current_alignment = next_field_align<uint8_t>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+      current_alignment = next_field_align<char>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+      current_alignment = next_field_align<float>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+      current_alignment = next_field_align<double>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+      current_alignment = next_field_align<int16_t>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+      current_alignment = next_field_align<uint16_t>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+      current_alignment = next_field_align<int32_t>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+      current_alignment = next_field_align<uint32_t>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+      current_alignment = next_field_align<int64_t>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+      current_alignment = next_field_align<uint64_t>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
+      current_alignment = next_field_align_string<std::string>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
+      current_alignment = next_field_align_string<std::wstring>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
+      {
+        auto sub_members = static_cast<const MembersType *>(member->members_->data);
+        if (!member->is_array_) {
+          current_alignment += getEstimatedSerializedSize(sub_members, field, current_alignment);
+        } else {
+          void * subros_message = nullptr;
+          size_t array_size = 0;
+          size_t sub_members_size = sub_members->size_of_;
+          const MembersLayout & sub_layout = getLayout(sub_members);
+          size_t max_align = sub_layout.max_align;
+
+          if (member->array_size_ && !member->is_upper_bound_) {
+            subros_message = field;
+            array_size = member->array_size_;
           } else {
-            void * subros_message = nullptr;
-            size_t array_size = 0;
-            size_t sub_members_size = sub_members->size_of_;
-            size_t max_align = calculateMaxAlign(sub_members);
-
-            if (member->array_size_ && !member->is_upper_bound_) {
-              subros_message = field;
-              array_size = member->array_size_;
-            } else {
-              array_size = get_array_size_and_assign_field(
-                member, field, subros_message, sub_members_size, max_align);
-
-              // Length serialization
-              current_alignment += 4 + eprosima::fastcdr::Cdr::alignment(current_alignment, 4);
-            }
+            array_size = get_array_size_and_assign_field(
+              member, field, subros_message, sub_members_size, max_align);
 
-            for (size_t index = 0; index < array_size; ++index) {
-              current_alignment += getEstimatedSerializedSize(
-                sub_members, subros_message, current_alignment);
-              subros_message = static_cast<char *>(subros_message) + sub_members_size;
-              subros_message = align_(max_align, subros_message);
-            }
+            // Length serialization
+            current_alignment += 4 + eprosima::fastcdr::Cdr::alignment(current_alignment, 4);
+          }
+
+          for (size_t index = 0; index < array_size; ++index) {
+            current_alignment += getEstimatedSerializedSize(
+              sub_members, subros_message, current_alignment);
+            subros_message = static_cast<char *>(subros_message) + sub_layout.stride;
           }
         }
-        break;
-      default:
-        throw std::runtime_error("unknown type");
-    }
+      }
+      break;
+    default:
+      throw std::runtime_error("unknown type");
   }
 
-  return current_alignment - initial_alignment;
+  return current_alignment;
+}
+
+// Fast CDR swaps arrays sent with the other endianness one element at a time,
+// copy them as raw bytes and swap them in bulk instead.
+template<typename T>
+inline void deserialize_array(eprosima::fastcdr::Cdr & deser, T * data, size_t size)
+{
+  if (sizeof(T) == 1 || size < 2 || deser.endianness() == eprosima::fastcdr::Cdr::DEFAULT_ENDIAN) {
+    deser.deserializeArray(data, size);
+    return;
+  }
+  // The first element aligns the stream, the others follow without padding
+  deser.deserializeArray(data, 1);
+  deser.deserializeArray(reinterpret_cast<uint8_t *>(data + 1), (size - 1) * sizeof(T));
+  rmw_fastrtps_shared_cpp::byte_swap(data + 1, size - 1);
+}
+
+template<typename T>
+inline void deserialize_sequence(eprosima::fastcdr::Cdr & deser, std::vector<T> & vector)
+{
+  uint32_t size = 0;
+  deser >> size;
+  vector.resize(size);
+  deserialize_array(deser, vector.data(), size);
+}
+
+inline void deserialize_sequence(eprosima::fastcdr::Cdr & deser, std::vector<bool> & vector)
+{
+  deser >> vector;
 }
 
 template<typename T>
@@ -736,13 +1036,13 @@ void deserialize_field(
   if (!member->is_array_) {
     deser >> *static_cast<T *>(field);
   } else if (member->array_size_ && !member->is_upper_bound_) {
-    deser.deserializeArray(static_cast<T *>(field), member->array_size_);
+    deserialize_array(deser, static_cast<T *>(field), member->array_size_);
   } else {
     auto & vector = *reinterpret_cast<std::vector<T> *>(field);
     if (call_new) {
       new(&vector) std::vector<T>;
     }
-    deser >> vector;
+    deserialize_sequence(deser, vector);
   }
 }
 
@@ -753,28 +1053,26 @@ inline void deserialize_field<std::string>(
   eprosima::fastcdr::Cdr & deser,
   bool call_new)
 {
+  using CppStringHelper = StringHelper<rosidl_typesupport_introspection_cpp::MessageMembers>;
   if (!member->is_array_) {
-    if (call_new) {
-      // Because std::string is a complex datatype, we need to make sure that
-      // the memory is initialized to something reasonable before eventually
-      // passing it as a reference to Fast-CDR.
-      new(field) std::string();
-    }
-    deser >> *static_cast<std::string *>(field);
+    CppStringHelper::assign(deser, field, call_new);
   } else if (member->array_size_ && !member->is_upper_bound_) {
     std::string * array = static_cast<std::string *>(field);
-    if (call_new) {
-      for (size_t i = 0; i < member->array_size_; ++i) {
-        new(&array[i]) std::string();
-      }
+    for (size_t i = 0; i < member->array_size_; ++i) {
+      CppStringHelper::assign(deser, &array[i], call_new);
     }
-    deser.deserializeArray(array, member->array_size_);
   } else {
     auto & vector = *reinterpret_cast<std::vector<std::string> *>(field);
     if (call_new) {
       new(&vector) std::vector<std::string>;
     }
-    deser >> vector;
+    uint32_t size = 0;
+    deser >> size;
+    // Strings kept by the resize are overwritten in place
+    vector.resize(size);
+    for (auto & str : vector) {
+      CppStringHelper::assign(deser, &str, false);
+    }
   }
 }
 
@@ -786,11 +1084,8 @@ inline void deserialize_field<std::wstring>(
   bool call_new)
 {
   (void)call_new;
-  std::wstring wstr;
   if (!member->is_array_) {
-    deser >> wstr;
-    rosidl_typesupport_fastrtps_cpp::wstring_to_u16string(
-      wstr, *static_cast<std::u16string *>(field));
+    deserialize_wstring(deser, *static_cast<std::u16string *>(field));
   } else {
     uint32_t size;
     if (member->array_size_ && !member->is_upper_bound_) {
@@ -801,13 +1096,51 @@ inline void deserialize_field<std::wstring>(
     }
     for (size_t i = 0; i < size; ++i) {
       void * element = member->get_function(field, i);
-      auto u16str = static_cast<std::u16string *>(element);
-      deser >> wstr;
-      rosidl_typesupport_fastrtps_cpp::wstring_to_u16string(wstr, *u16str);
+      deserialize_wstring(deser, *static_cast<std::u16string *>(element));
     }
   }
 }
 
+/**
+ * Point an empty C sequence at its elements in the CDR buffer, when views are enabled.
+ *
+ * The elements must be stored as they are in memory: suitably aligned, with the host
+ * endianness, and the sequence must not own a buffer already.
+ * \return true if the sequence now is a view, false if it still has to be deserialized.
+ */
+template<typename SequenceT>
+bool deserialize_sequence_view(eprosima::fastcdr::Cdr & deser, SequenceT & sequence, size_t size)
+{
+  using T = typename std::remove_pointer<decltype(sequence.data)>::type;
+  SequenceViews * views = current_sequence_views();
+  // bools are normalized on deserialization
+  if (!views || std::is_same<T, bool>::value || sequence.capacity != 0 || size == 0 ||
+    size * sizeof(T) < views->min_size ||
+    (sizeof(T) > 1 && deser.endianness() != eprosima::fastcdr::Cdr::DEFAULT_ENDIAN))
+  {
+    return false;
+  }
+  const char * position = deser.getCurrentPosition();
+  const size_t padding = eprosima::fastcdr::Cdr::alignment(
+    static_cast<size_t>(position - views->cdr_origin), sizeof(T));
+  const char * elements = position + padding;
+  if (reinterpret_cast<uintptr_t>(elements) % alignof(T) != 0) {
+    return false;
+  }
+  if (!deser.jump(padding + (size - 1) * sizeof(T))) {
+    throw std::runtime_error("sequence overruns the CDR buffer");
+  }
+  // Jumping does not tell Fast CDR the size of the last element, from which it aligns the
+  // next field, reading it does
+  T last;
+  deser.deserializeArray(&last, 1);
+  sequence.data = reinterpret_cast<T *>(const_cast<char *>(elements));
+  sequence.size = size;
+  sequence.capacity = size;
+  views->sequences.push_back(&sequence);
+  return true;
+}
+
 template<typename T>
 void deserialize_field(
   const rosidl_typesupport_introspection_c__MessageMember * member,
@@ -819,13 +1152,18 @@ void deserialize_field(
   if (!member->is_array_) {
     deser >> *static_cast<T *>(field);
   } else if (member->array_size_ && !member->is_upper_bound_) {
-    deser.deserializeArray(static_cast<T *>(field), member->array_size_);
+    deserialize_array(deser, static_cast<T *>(field), member->array_size_);
   } else {
     auto & data = *reinterpret_cast<typename GenericCSequence<T>::type *>(field);
     int32_t dsize = 0;
     deser >> dsize;
-    GenericCSequence<T>::init(&data, dsize);
-    deser.deserializeArray(reinterpret_cast<T *>(data.data), dsize);
+    if (deserialize_sequence_view(deser, data, dsize)) {
+      return;
+    }
+    if (!resize_c_sequence(&data, dsize, sizeof(T))) {
+      throw std::runtime_error("unable to resize primitive sequence");
+    }
+    deserialize_array(deser, reinterpret_cast<T *>(data.data), dsize);
   }
 }
 
@@ -836,43 +1174,32 @@ inline void deserialize_field<std::string>(
   eprosima::fastcdr::Cdr & deser,
   bool call_new)
 {
-  (void)call_new;
+  using CStringHelper = StringHelper<rosidl_typesupport_introspection_c__MessageMembers>;
   if (!member->is_array_) {
-    using CStringHelper = StringHelper<rosidl_typesupport_introspection_c__MessageMembers>;
     CStringHelper::assign(deser, field, call_new);
+  } else if (member->array_size_ && !member->is_upper_bound_) {
+    auto deser_field = static_cast<rosidl_generator_c__String *>(field);
+    for (size_t i = 0; i < member->array_size_; ++i) {
+      CStringHelper::assign(deser, &deser_field[i], call_new);
+    }
   } else {
-    if (member->array_size_ && !member->is_upper_bound_) {
-      auto deser_field = static_cast<rosidl_generator_c__String *>(field);
-      // tmpstring is defined here and not below to avoid
-      // memory allocation in every iteration of the for loop
-      std::string tmpstring;
-      for (size_t i = 0; i < member->array_size_; ++i) {
-        deser.deserialize(tmpstring);
-        if (!rosidl_generator_c__String__assign(&deser_field[i], tmpstring.c_str())) {
-          throw std::runtime_error("unable to assign rosidl_generator_c__String");
-        }
-      }
-    } else {
-      std::vector<std::string> cpp_string_vector;
-      deser >> cpp_string_vector;
+    uint32_t size = 0;
+    deser >> size;
 
-      auto & string_sequence_field =
-        *reinterpret_cast<rosidl_generator_c__String__Sequence *>(field);
-      if (
-        !rosidl_generator_c__String__Sequence__init(
-          &string_sequence_field, cpp_string_vector.size()))
-      {
-        throw std::runtime_error("unable to initialize rosidl_generator_c__String array");
-      }
+    auto & string_sequence_field =
+      *reinterpret_cast<rosidl_generator_c__String__Sequence *>(field);
+    if (!resize_c_sequence(
+        &string_sequence_field, size, sizeof(rosidl_generator_c__String),
+        [](void * element) {
+          return rosidl_generator_c__String__init(
+            static_cast<rosidl_generator_c__String *>(element));
+        }))
+    {
+      throw std::runtime_error("unable to initialize rosidl_generator_c__String array");
+    }
 
-      for (size_t i = 0; i < cpp_string_vector.size(); ++i) {
-        if (
-          !rosidl_generator_c__String__assign(
-            &string_sequence_field.data[i], cpp_string_vector[i].c_str()))
-        {
-          throw std::runtime_error("unable to assign rosidl_generator_c__String");
-        }
-      }
+    for (size_t i = 0; i < size; ++i) {
+      CStringHelper::assign(deser, &string_sequence_field.data[i], call_new);
     }
   }
 }
@@ -885,27 +1212,28 @@ inline void deserialize_field<std::wstring>(
   bool call_new)
 {
   (void)call_new;
-  std::wstring wstr;
   if (!member->is_array_) {
-    deser >> wstr;
-    rosidl_typesupport_fastrtps_c::wstring_to_u16string(
-      wstr, *static_cast<rosidl_generator_c__U16String *>(field));
+    deserialize_wstring(deser, *static_cast<rosidl_generator_c__U16String *>(field));
   } else if (member->array_size_ && !member->is_upper_bound_) {
     auto array = static_cast<rosidl_generator_c__U16String *>(field);
     for (size_t i = 0; i < member->array_size_; ++i) {
-      deser >> wstr;
-      rosidl_typesupport_fastrtps_c::wstring_to_u16string(wstr, array[i]);
+      deserialize_wstring(deser, array[i]);
     }
   } else {
     uint32_t size;
     deser >> size;
     auto sequence = static_cast<rosidl_generator_c__U16String__Sequence *>(field);
-    if (!rosidl_generator_c__U16String__Sequence__init(sequence, size)) {
+    if (!resize_c_sequence(
+        sequence, size, sizeof(rosidl_generator_c__U16String),
+        [](void * element) {
+          return rosidl_generator_c__U16String__init(
+            static_cast<rosidl_generator_c__U16String *>(element));
+        }))
+    {
       throw std::runtime_error("unable to initialize rosidl_generator_c__U16String sequence");
     }
     for (size_t i = 0; i < sequence->size; ++i) {
-      deser >> wstr;
-      rosidl_typesupport_fastrtps_c::wstring_to_u16string(wstr, sequence->data[i]);
+      deserialize_wstring(deser, sequence->data[i]);
     }
   }
 }
@@ -915,14 +1243,20 @@ inline size_t get_submessage_array_deserialize(
   eprosima::fastcdr::Cdr & deser,
   void * field,
   void * & subros_message,
-  bool call_new,
+  bool & call_new,
   size_t sub_members_size,
   size_t max_align)
 {
-  (void)member;
   uint32_t vsize = 0;
   // Deserialize length
   deser >> vsize;
+  if (!call_new && member->resize_function && member->get_function) {
+    // std::vector::resize keeps both the capacity and the elements already there, so the
+    // strings and sequences inside them are deserialized into their existing buffers
+    member->resize_function(field, vsize);
+    subros_message = vsize ? member->get_function(field, 0) : nullptr;
+    return vsize;
+  }
   auto vector = reinterpret_cast<std::vector<unsigned char> *>(field);
   if (call_new) {
     new(vector) std::vector<unsigned char>;
@@ -930,6 +1264,7 @@ inline size_t get_submessage_array_deserialize(
   void * ptr = reinterpret_cast<void *>(sub_members_size);
   vector->resize(vsize * (size_t)align_(max_align, ptr));
   subros_message = reinterpret_cast<void *>(vector->data());
+  call_new = true;
   return vsize;
 }
 
@@ -938,7 +1273,7 @@ inline size_t get_submessage_array_deserialize(
   eprosima::fastcdr::Cdr & deser,
   void * field,
   void * & subros_message,
-  bool,
+  bool &,
   size_t sub_members_size,
   size_t)
 {
@@ -947,7 +1282,9 @@ inline size_t get_submessage_array_deserialize(
   uint32_t vsize = 0;
   deser >> vsize;
   auto tmpsequence = static_cast<rosidl_generator_c__void__Sequence *>(field);
-  rosidl_generator_c__void__Sequence__init(tmpsequence, vsize, sub_members_size);
+  if (!resize_c_sequence(tmpsequence, vsize, sub_members_size)) {
+    throw std::runtime_error("unable to resize message sequence");
+  }
   subros_message = reinterpret_cast<void *>(tmpsequence->data);
   return vsize;
 }
@@ -965,83 +1302,160 @@ bool TypeSupport<MembersType>::deserializeROSmessage(
   for (uint32_t i = 0; i < members->member_count_; ++i) {
     const auto * member = members->members_ + i;
     void * field = static_cast<char *>(ros_message) + member->offset_;
-    switch (member->type_id_) {
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
-        deserialize_field<bool>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
-        deserialize_field<uint8_t>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
-        deserialize_field<char>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
-        deserialize_field<float>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
-        deserialize_field<double>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
-        deserialize_field<int16_t>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
-        deserialize_field<uint16_t>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
-        deserialize_field<int32_t>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
-        deserialize_field<uint32_t>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
-        deserialize_field<int64_t>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
-        deserialize_field<uint64_t>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
-        deserialize_field<std::string>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
-        deserialize_field<std::wstring>(member, field, deser, call_new);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
-        {
-          auto sub_members = (const MembersType *)member->members_->data;
-          if (!member->is_array_) {
-            deserializeROSmessage(deser, sub_members, field, call_new);
+    deserializeMember(deser, member, field, call_new);
+  }
+
+  return true;
+}
+
+template<typename MembersType>
+void TypeSupport<MembersType>::deserializeMember(
+  eprosima::fastcdr::Cdr & deser,
+  const MemberType * member,
+  void * field,
+  bool call_new) const
+{
+  switch (member->type_id_) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
+      deserialize_field<bool>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+      deserialize_field<uint8_t>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+      deserialize_field<char>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+      deserialize_field<float>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+      deserialize_field<double>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+      deserialize_field<int16_t>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+      deserialize_field<uint16_t>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+      deserialize_field<int32_t>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+      deserialize_field<uint32_t>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+      deserialize_field<int64_t>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+      deserialize_field<uint64_t>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
+      deserialize_field<std::string>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
+      deserialize_field<std::wstring>(member, field, deser, call_new);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
+      {
+        auto sub_members = (const MembersType *)member->members_->data;
+        if (!member->is_array_) {
+          deserializeROSmessage(deser, sub_members, field, call_new);
+        } else {
+          void * subros_message = nullptr;
+          size_t array_size = 0;
+          size_t sub_members_size = sub_members->size_of_;
+          const MembersLayout & sub_layout = getLayout(sub_members);
+          size_t max_align = sub_layout.max_align;
+          bool recall_new = call_new;
+
+          if (member->array_size_ && !member->is_upper_bound_) {
+            subros_message = field;
+            array_size = member->array_size_;
           } else {
-            void * subros_message = nullptr;
-            size_t array_size = 0;
-            size_t sub_members_size = sub_members->size_of_;
-            size_t max_align = calculateMaxAlign(sub_members);
-            bool recall_new = call_new;
-
-            if (member->array_size_ && !member->is_upper_bound_) {
-              subros_message = field;
-              array_size = member->array_size_;
-            } else {
-              array_size = get_submessage_array_deserialize(
-                member, deser, field, subros_message,
-                call_new, sub_members_size, max_align);
-              recall_new = true;
-            }
+            array_size = get_submessage_array_deserialize(
+              member, deser, field, subros_message,
+              recall_new, sub_members_size, max_align);
+          }
 
+          if (!deserializeArrayInParallel(
+              deser, sub_members, subros_message, array_size, recall_new))
+          {
             for (size_t index = 0; index < array_size; ++index) {
               deserializeROSmessage(deser, sub_members, subros_message, recall_new);
-              subros_message = static_cast<char *>(subros_message) + sub_members_size;
-              subros_message = align_(max_align, subros_message);
+              subros_message = static_cast<char *>(subros_message) + sub_layout.stride;
             }
           }
         }
-        break;
-      default:
-        throw std::runtime_error("unknown type");
-    }
+      }
+      break;
+    default:
+      throw std::runtime_error("unknown type");
   }
+}
 
+template<typename MembersType>
+bool TypeSupport<MembersType>::deserializeArrayInParallel(
+  eprosima::fastcdr::Cdr & deser,
+  const MembersType * members,
+  void * array,
+  size_t count,
+  bool call_new) const
+{
+  const size_t min_size = get_parallel_deserialization_min_size();
+  const MembersLayout & layout = getLayout(members);
+  if (min_size == 0 || count < 2 || !layout.is_fixed_size) {
+    return false;
+  }
+
+  // CDR alignment is relative to the end of the encapsulation, at the start of the buffer
+  char * origin = deser.getBufferPointer() + 4;
+  const size_t start = static_cast<size_t>(deser.getCurrentPosition() - origin);
+  const size_t element_size = layout.cdr_sizes[start % layout.cdr_align];
+  // Only then every element starts at the same alignment, and so has the same size, which
+  // makes the offset of each element known up front
+  if (element_size % layout.cdr_align != 0 || element_size * count < min_size) {
+    return false;
+  }
+  // The last element is deserialized on the calling thread: jumping does not tell Fast CDR
+  // the size of the last field, from which it aligns the next one, reading it does
+  const size_t parallel_count = count - 1;
+  if (!deser.jump(element_size * parallel_count)) {
+    throw std::runtime_error("array of messages overruns the CDR buffer");
+  }
+  const size_t end = start + element_size * parallel_count;
+  deserializeROSmessage(
+    deser, members, static_cast<char *>(array) + parallel_count * layout.stride, call_new);
+
+  WorkerPool & pool = WorkerPool::get_instance();
+  const size_t chunk_count = std::min(parallel_count, pool.concurrency());
+  const size_t chunk_size = (parallel_count + chunk_count - 1) / chunk_count;
+  const auto endianness = deser.endianness();
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  pool.parallel_for(
+    chunk_count, [&](size_t chunk) {
+      const size_t first = chunk * chunk_size;
+      const size_t last = std::min(parallel_count, first + chunk_size);
+      try {
+        eprosima::fastcdr::FastBuffer buffer(origin, end);
+        eprosima::fastcdr::Cdr chunk_deser(buffer, endianness, eprosima::fastcdr::Cdr::DDS_CDR);
+        chunk_deser.jump(start + first * element_size);
+        for (size_t index = first; index < last; ++index) {
+          deserializeROSmessage(
+            chunk_deser, members, static_cast<char *>(array) + index * layout.stride, call_new);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    });
+  if (error) {
+    std::rethrow_exception(error);
+  }
   return true;
 }
 
@@ -1139,7 +1553,18 @@ size_t TypeSupport<MembersType>::getEstimatedSerializedSize(
 
   (void)impl;
   if (members_->member_count_ != 0) {
-    ret_val += TypeSupport::getEstimatedSerializedSize(members_, ros_message, 0);
+    size_t current_alignment = 0;
+    for (const auto & step : plan_) {
+      void * field = const_cast<char *>(static_cast<const char *>(ros_message)) + step.offset;
+      if (step.member) {
+        current_alignment = getMemberEstimatedSerializedSize(step.member, field, current_alignment);
+      } else {
+        current_alignment += eprosima::fastcdr::Cdr::alignment(
+          current_alignment, step.primitive_size);
+        current_alignment += step.primitive_size * step.count;
+      }
+    }
+    ret_val += current_alignment;
   } else {
     ret_val += 1;
   }
@@ -1158,8 +1583,29 @@ bool TypeSupport<MembersType>::serializeROSmessage(
   ser.serialize_encapsulation();
 
   (void)impl;
-  if (members_->member_count_ != 0) {
-    TypeSupport::serializeROSmessage(ser, members_, ros_message);
+  if (plain_size_ && ser.endianness() == eprosima::fastcdr::Cdr::DEFAULT_ENDIAN) {
+    ser.serializeArray(static_cast<const uint8_t *>(ros_message), plain_size_);
+  } else if (members_->member_count_ != 0) {
+    for (const auto & step : plan_) {
+      void * field = const_cast<char *>(static_cast<const char *>(ros_message)) + step.offset;
+      switch (step.primitive_size) {
+        case 1:
+          ser.serializeArray(static_cast<uint8_t *>(field), step.count);
+          break;
+        case 2:
+          ser.serializeArray(static_cast<uint16_t *>(field), step.count);
+          break;
+        case 4:
+          ser.serializeArray(static_cast<uint32_t *>(field), step.count);
+          break;
+        case 8:
+          ser.serializeArray(static_cast<uint64_t *>(field), step.count);
+          break;
+        default:
+          serializeMember(ser, step.member, field);
+          break;
+      }
+    }
   } else {
     ser << (uint8_t)0;
   }
@@ -1178,8 +1624,29 @@ bool TypeSupport<MembersType>::deserializeROSmessage(
   deser.read_encapsulation();
 
   (void)impl;
-  if (members_->member_count_ != 0) {
-    TypeSupport::deserializeROSmessage(deser, members_, ros_message, false);
+  if (plain_size_ && deser.endianness() == eprosima::fastcdr::Cdr::DEFAULT_ENDIAN) {
+    deser.deserializeArray(static_cast<uint8_t *>(ros_message), plain_size_);
+  } else if (members_->member_count_ != 0) {
+    for (const auto & step : plan_) {
+      void * field = static_cast<char *>(ros_message) + step.offset;
+      switch (step.primitive_size) {
+        case 1:
+          deserialize_array(deser, static_cast<uint8_t *>(field), step.count);
+          break;
+        case 2:
+          deserialize_array(deser, static_cast<uint16_t *>(field), step.count);
+          break;
+        case 4:
+          deserialize_array(deser, static_cast<uint32_t *>(field), step.count);
+          break;
+        case 8:
+          deserialize_array(deser, static_cast<uint64_t *>(field), step.count);
+          break;
+        default:
+          deserializeMember(deser, step.member, field, false);
+          break;
+      }
+    }
   } else {
     uint8_t dump = 0;
     deser >> dump;
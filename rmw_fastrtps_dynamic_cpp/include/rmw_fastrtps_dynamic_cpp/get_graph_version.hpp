@@ -0,0 +1,42 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_DYNAMIC_CPP__GET_GRAPH_VERSION_HPP_
+#define RMW_FASTRTPS_DYNAMIC_CPP__GET_GRAPH_VERSION_HPP_
+
+#include <cstdint>
+
+#include "rmw/rmw.h"
+#include "rmw_fastrtps_dynamic_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+/// Return the version of the ROS graph as seen by a node.
+/**
+ * The version increases every time a node, publisher, subscription, service or
+ * client appears or goes away, so two calls returning the same version mean the
+ * graph did not change in between.
+ * The function returns `0` when either the node handle is `NULL` or when the
+ * node handle is from a different rmw implementation, valid versions start at `1`.
+ *
+ * \return graph version if successful, otherwise `0`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+uint64_t
+get_graph_version(const rmw_node_t * node);
+
+}  // namespace rmw_fastrtps_dynamic_cpp
+
+#endif  // RMW_FASTRTPS_DYNAMIC_CPP__GET_GRAPH_VERSION_HPP_
@@ -0,0 +1,48 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_DYNAMIC_CPP__TAKE_CHANGED_TOPICS_HPP_
+#define RMW_FASTRTPS_DYNAMIC_CPP__TAKE_CHANGED_TOPICS_HPP_
+
+#include <string>
+#include <vector>
+
+#include "rmw/rmw.h"
+#include "rmw_fastrtps_dynamic_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+/// Take the names of the topics and services whose endpoints changed.
+/**
+ * Returns the topics and services on which a publisher, subscription, service or
+ * client appeared or went away since the previous call for the same node, so that
+ * a graph guard condition wake-up only requires rescanning those.
+ * Topics are reported with their ROS name, services with their service name.
+ * Changes are only recorded for the nodes this was called for: the first call for a node
+ * starts recording them and returns nothing.
+ *
+ * \param node the node whose graph guard condition was triggered
+ * \param topic_names [out] the changed names
+ * \return RMW_RET_OK if successful, or
+ * \return RMW_RET_INVALID_ARGUMENT if the node handle is `NULL`, or
+ * \return RMW_RET_ERROR if the node handle is from a different rmw implementation
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+take_changed_topics(const rmw_node_t * node, std::vector<std::string> & topic_names);
+
+}  // namespace rmw_fastrtps_dynamic_cpp
+
+#endif  // RMW_FASTRTPS_DYNAMIC_CPP__TAKE_CHANGED_TOPICS_HPP_
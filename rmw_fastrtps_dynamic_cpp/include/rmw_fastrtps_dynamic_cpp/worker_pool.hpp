@@ -0,0 +1,109 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_DYNAMIC_CPP__WORKER_POOL_HPP_
+#define RMW_FASTRTPS_DYNAMIC_CPP__WORKER_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rmw_fastrtps_dynamic_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+/**
+ * Threads sharing the work of a single job at a time, one per core.
+ *
+ * The workers are started by the first job, the calling thread takes part in every job.
+ */
+class WorkerPool
+{
+public:
+  RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+  static WorkerPool & get_instance();
+
+  RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+  ~WorkerPool();
+
+  /// Run task(i) for every i in [0, count) and wait for all of them.
+  /**
+   * The tasks run on the calling thread only if another job is in progress.
+   * \param count number of tasks.
+   * \param task function to run, must not throw.
+   */
+  RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+  void parallel_for(size_t count, const std::function<void(size_t)> & task);
+
+  /// Number of threads running a job, the calling one included.
+  size_t concurrency() const
+  {
+    return worker_count_ + 1;
+  }
+
+  /// Number of calls to parallel_for() so far, whether their tasks ran in parallel or not.
+  size_t job_count() const
+  {
+    return job_count_.load(std::memory_order_relaxed);
+  }
+
+private:
+  WorkerPool();
+
+  void run_tasks();
+
+  void worker_main();
+
+  const size_t worker_count_;
+  std::vector<std::thread> workers_;
+  std::atomic<size_t> job_count_{0};
+
+  // Held for the whole duration of a job.
+  std::mutex job_mutex_;
+
+  std::mutex mutex_;
+  std::condition_variable job_started_;
+  std::condition_variable job_done_;
+  const std::function<void(size_t)> * task_ = nullptr;
+  size_t count_ = 0;
+  std::atomic<size_t> next_{0};
+  size_t pending_ = 0;
+  size_t active_workers_ = 0;
+  size_t generation_ = 0;
+  bool stop_ = false;
+};
+
+/// Smallest serialized size of an array of submessages deserialized in parallel.
+/**
+ * Initialized from the RMW_FASTRTPS_PARALLEL_DESERIALIZATION_MIN_SIZE environment variable,
+ * in bytes.
+ * \return the size, or 0 if arrays are always deserialized on the calling thread.
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+size_t
+get_parallel_deserialization_min_size();
+
+/// Override the size returned by get_parallel_deserialization_min_size(), 0 to disable.
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+void
+set_parallel_deserialization_min_size(size_t min_size);
+
+}  // namespace rmw_fastrtps_dynamic_cpp
+
+#endif  // RMW_FASTRTPS_DYNAMIC_CPP__WORKER_POOL_HPP_
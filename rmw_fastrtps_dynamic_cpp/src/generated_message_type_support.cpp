@@ -0,0 +1,60 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cassert>
+#include <string>
+
+#include "rmw_fastrtps_dynamic_cpp/GeneratedMessageTypeSupport.hpp"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+GeneratedMessageTypeSupport::GeneratedMessageTypeSupport(
+  const message_type_support_callbacks_t * callbacks,
+  const std::string & type_name,
+  const void * ros_type_support)
+: BaseTypeSupport(ros_type_support),
+  callbacks_(callbacks)
+{
+  assert(callbacks);
+  m_isGetKeyDefined = false;
+  setName(type_name.c_str());
+  m_typeSize = serialization_.init(callbacks_, max_size_bound_);
+}
+
+size_t GeneratedMessageTypeSupport::getEstimatedSerializedSize(
+  const void * ros_message, const void * impl) const
+{
+  (void)impl;
+  if (max_size_bound_) {
+    return m_typeSize;
+  }
+  return serialization_.getEstimatedSerializedSize(callbacks_, ros_message);
+}
+
+bool GeneratedMessageTypeSupport::serializeROSmessage(
+  const void * ros_message, eprosima::fastcdr::Cdr & ser, const void * impl) const
+{
+  (void)impl;
+  return serialization_.serialize(callbacks_, ros_message, ser);
+}
+
+bool GeneratedMessageTypeSupport::deserializeROSmessage(
+  eprosima::fastcdr::Cdr & deser, void * ros_message, const void * impl) const
+{
+  (void)impl;
+  return serialization_.deserialize(callbacks_, deser, ros_message);
+}
+
+}  // namespace rmw_fastrtps_dynamic_cpp
@@ -0,0 +1,36 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rmw_fastrtps_dynamic_cpp/get_graph_version.hpp"
+
+#include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_dynamic_cpp/identifier.hpp"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+uint64_t
+get_graph_version(const rmw_node_t * node)
+{
+  if (!node) {
+    return 0u;
+  }
+  if (node->implementation_identifier != eprosima_fastrtps_identifier) {
+    return 0u;
+  }
+  auto impl = static_cast<CustomParticipantInfo *>(node->data);
+  return impl->listener->get_graph_version();
+}
+
+}  // namespace rmw_fastrtps_dynamic_cpp
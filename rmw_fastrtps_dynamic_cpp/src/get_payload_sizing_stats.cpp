@@ -0,0 +1,31 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rmw_fastrtps_dynamic_cpp/get_payload_sizing_stats.hpp"
+
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_dynamic_cpp/identifier.hpp"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+rmw_ret_t
+get_payload_sizing_stats(
+  const rmw_publisher_t * publisher, rmw_fastrtps_shared_cpp::PayloadSizingStats & stats)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_publisher_get_payload_sizing_stats(
+    eprosima_fastrtps_identifier, publisher, stats);
+}
+
+}  // namespace rmw_fastrtps_dynamic_cpp
@@ -0,0 +1,300 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+
+#include "fastrtps/rtps/common/SerializedPayload.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+
+#include "rosidl_typesupport_introspection_c/field_types.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/env.hpp"
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+
+#include "rmw_fastrtps_dynamic_cpp/identifier.hpp"
+
+#include "loaned_message.hpp"
+#include "type_support_common.hpp"
+
+using BaseTypeSupport = rmw_fastrtps_dynamic_cpp::BaseTypeSupport;
+using SerializedPayload_t = eprosima::fastrtps::rtps::SerializedPayload_t;
+
+namespace
+{
+
+/**
+ * Bookkeeping of a loaned message, allocated right in front of it.
+ */
+struct LoanedMessage
+{
+  const rosidl_typesupport_introspection_c__MessageMembers * members;
+  // The received sample, which the sequence views point into.
+  std::unique_ptr<SerializedPayload_t> payload;
+  rmw_fastrtps_dynamic_cpp::SequenceViews views;
+};
+
+// Keeps the message that follows the bookkeeping suitably aligned.
+constexpr size_t loan_header_size =
+  (sizeof(LoanedMessage) + alignof(std::max_align_t) - 1) /
+  alignof(std::max_align_t) * alignof(std::max_align_t);
+
+LoanedMessage * get_loan(void * ros_message)
+{
+  return reinterpret_cast<LoanedMessage *>(static_cast<char *>(ros_message) - loan_header_size);
+}
+
+/**
+ * Sample buffers of the returned loans.
+ *
+ * They are handed over to Fast-RTPS in exchange of the next loaned samples, so once as many
+ * buffers as loans outstanding at once exist, taking on loan does not allocate.
+ */
+class PayloadPool
+{
+public:
+  std::unique_ptr<SerializedPayload_t> acquire()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!payloads_.empty()) {
+        auto payload = std::move(payloads_.back());
+        payloads_.pop_back();
+        return payload;
+      }
+    }
+    return std::unique_ptr<SerializedPayload_t>(new (std::nothrow) SerializedPayload_t());
+  }
+
+  void release(std::unique_ptr<SerializedPayload_t> payload)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (payloads_.size() < max_payloads) {
+      payloads_.push_back(std::move(payload));
+    }
+  }
+
+private:
+  static constexpr size_t max_payloads = 16;
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<SerializedPayload_t>> payloads_;
+};
+
+PayloadPool & get_payload_pool()
+{
+  static PayloadPool pool;
+  return pool;
+}
+
+/// Whether a C message has, at any depth, sequences of 8 bytes primitives.
+bool has_sequences_of_8_bytes(const rosidl_typesupport_introspection_c__MessageMembers * members)
+{
+  for (uint32_t i = 0; i < members->member_count_; ++i) {
+    const auto & member = members->members_[i];
+    if (member.type_id_ == rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE) {
+      auto sub_members = static_cast<const rosidl_typesupport_introspection_c__MessageMembers *>(
+        member.members_->data);
+      if (has_sequences_of_8_bytes(sub_members)) {
+        return true;
+      }
+    } else if (
+      member.is_array_ && (!member.array_size_ || member.is_upper_bound_) &&
+      rmw_fastrtps_dynamic_cpp::plain_primitive_size(member.type_id_) == 8)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void release_loan(void * ros_message)
+{
+  LoanedMessage * loan = get_loan(ros_message);
+  // The views do not own their elements, detach them so finalizing does not free them.
+  for (void * sequence : loan->views.sequences) {
+    auto view = static_cast<rmw_fastrtps_dynamic_cpp::rosidl_generator_c__void__Sequence *>(
+      sequence);
+    view->data = nullptr;
+    view->size = 0;
+    view->capacity = 0;
+  }
+  loan->members->fini_function(ros_message);
+  get_payload_pool().release(std::move(loan->payload));
+  loan->~LoanedMessage();
+  free(loan);
+}
+
+bool read_sequence_view_min_size(size_t & min_size)
+{
+  uint64_t value = 0;
+  if (!rmw_fastrtps_shared_cpp::get_env_uint(
+      "RMW_FASTRTPS_LOAN_SEQUENCE_VIEWS_MIN_SIZE", SIZE_MAX, "messages are not loaned", value))
+  {
+    return false;
+  }
+  min_size = static_cast<size_t>(value);
+  return true;
+}
+
+}  // namespace
+
+bool
+get_sequence_view_min_size(size_t & min_size)
+{
+  static size_t configured_min_size = 0;
+  static const bool enabled = read_sequence_view_min_size(configured_min_size);
+  min_size = configured_min_size;
+  return enabled;
+}
+
+rmw_ret_t
+take_loaned_message(
+  const rmw_subscription_t * subscription,
+  void ** loaned_message,
+  bool * taken,
+  rmw_message_info_t * message_info)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(subscription, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(loaned_message, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(taken, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    subscription,
+    subscription->implementation_identifier,
+    eprosima_fastrtps_identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+  *taken = false;
+
+  size_t min_size = 0;
+  if (!subscription->can_loan_messages || !get_sequence_view_min_size(min_size)) {
+    RMW_SET_ERROR_MSG("subscription does not loan messages");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
+  auto type_support = static_cast<const BaseTypeSupport *>(info->type_support_impl_);
+  auto members = static_cast<const rosidl_typesupport_introspection_c__MessageMembers *>(
+    static_cast<const rosidl_message_type_support_t *>(type_support->ros_type_support())->data);
+
+  PayloadPool & pool = get_payload_pool();
+  std::unique_ptr<SerializedPayload_t> payload = pool.acquire();
+  if (!payload) {
+    RMW_SET_ERROR_MSG("failed to allocate payload");
+    return RMW_RET_BAD_ALLOC;
+  }
+  rmw_ret_t ret = rmw_fastrtps_shared_cpp::__rmw_take_payload(
+    eprosima_fastrtps_identifier, subscription, payload.get(), taken, message_info);
+  if (ret != RMW_RET_OK || !*taken) {
+    pool.release(std::move(payload));
+    return ret;
+  }
+
+  // CDR alignment is relative to the end of the 4 bytes encapsulation, which is never 8 bytes
+  // aligned in the malloc'd sample. Move the sample when 8 bytes elements could be viewed,
+  // it costs a single memmove where copying them would cost one allocation per sequence.
+  size_t cdr_offset = 0;
+  if (has_sequences_of_8_bytes(members)) {
+    const uint32_t length = payload->length;
+    try {
+      payload->reserve(length + 7);
+    } catch (const std::bad_alloc &) {
+      // The sample is lost, and the payload left without a buffer
+      *taken = false;
+      RMW_SET_ERROR_MSG("failed to allocate payload");
+      return RMW_RET_BAD_ALLOC;
+    }
+    const uintptr_t origin = reinterpret_cast<uintptr_t>(payload->data) + 4;
+    cdr_offset = (8 - origin % 8) % 8;
+    memmove(payload->data + cdr_offset, payload->data, length);
+  }
+
+  auto block = static_cast<char *>(malloc(loan_header_size + members->size_of_));
+  if (!block) {
+    pool.release(std::move(payload));
+    *taken = false;
+    RMW_SET_ERROR_MSG("failed to allocate loaned message");
+    return RMW_RET_BAD_ALLOC;
+  }
+  auto loan = new (block) LoanedMessage();
+  loan->members = members;
+  loan->payload = std::move(payload);
+  void * ros_message = block + loan_header_size;
+  members->init_function(ros_message, ROSIDL_RUNTIME_C_MSG_INIT_ALL);
+
+  auto data = reinterpret_cast<char *>(loan->payload->data) + cdr_offset;
+  eprosima::fastcdr::FastBuffer buffer(data, loan->payload->length);
+  eprosima::fastcdr::Cdr deser(
+    buffer,
+    eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
+    eprosima::fastcdr::Cdr::DDS_CDR);
+  // CDR alignment is relative to the end of the encapsulation
+  loan->views.cdr_origin = data + 4;
+  loan->views.min_size = min_size;
+
+  bool deserialized = false;
+  rmw_fastrtps_dynamic_cpp::current_sequence_views() = &loan->views;
+  try {
+    deserialized = type_support->deserializeROSmessage(deser, ros_message, type_support);
+  } catch (const std::exception & e) {
+    RMW_SET_ERROR_MSG(e.what());
+  } catch (...) {
+    RMW_SET_ERROR_MSG("failed to deserialize loaned message");
+  }
+  rmw_fastrtps_dynamic_cpp::current_sequence_views() = nullptr;
+
+  if (!deserialized) {
+    release_loan(ros_message);
+    *taken = false;
+    return RMW_RET_ERROR;
+  }
+  *loaned_message = ros_message;
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+return_loaned_message(
+  const rmw_subscription_t * subscription,
+  void * loaned_message)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(subscription, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(loaned_message, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    subscription,
+    subscription->implementation_identifier,
+    eprosima_fastrtps_identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+
+  if (!subscription->can_loan_messages) {
+    RMW_SET_ERROR_MSG("subscription does not loan messages");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  release_loan(loaned_message);
+  return RMW_RET_OK;
+}
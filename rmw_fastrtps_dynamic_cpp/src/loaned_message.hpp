@@ -0,0 +1,51 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LOANED_MESSAGE_HPP_
+#define LOANED_MESSAGE_HPP_
+
+#include <cstddef>
+
+#include "rmw/rmw.h"
+
+/// Whether subscriptions to C messages loan the messages they take.
+/**
+ * Enabled by setting the RMW_FASTRTPS_LOAN_SEQUENCE_VIEWS_MIN_SIZE environment variable to the
+ * size, in bytes, from which the primitive sequences of a loaned message point into the
+ * received sample instead of holding a copy of it. The variable is read once.
+ * \param[out] min_size that size, when enabled.
+ * \return true if enabled.
+ */
+bool
+get_sequence_view_min_size(size_t & min_size);
+
+/// Take the next message of a subscription on loan.
+/**
+ * The message and the sample its sequence views point into are owned by the middleware until
+ * the message is given back with return_loaned_message().
+ */
+rmw_ret_t
+take_loaned_message(
+  const rmw_subscription_t * subscription,
+  void ** loaned_message,
+  bool * taken,
+  rmw_message_info_t * message_info);
+
+/// Finalize a message taken with take_loaned_message() and release its sample.
+rmw_ret_t
+return_loaned_message(
+  const rmw_subscription_t * subscription,
+  void * loaned_message);
+
+#endif  // LOANED_MESSAGE_HPP_
@@ -27,6 +27,7 @@
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/names.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
+#include "rmw_fastrtps_shared_cpp/publish_mode.hpp"
 #include "rmw_fastrtps_shared_cpp/qos.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 
@@ -169,9 +170,10 @@ rmw_create_client(
   subscriberParam.topic.topicDataType = response_type_name;
   subscriberParam.topic.topicName = _create_topic_name(
     qos_policies, ros_service_response_prefix, service_name, "Reply");
+  subscriberParam.qos.m_userData.setDataVec(impl->endpoint_user_data);
 
   if (!impl->leave_middleware_default_qos) {
-    publisherParam.qos.m_publishMode.kind = eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE;
+    publisherParam.qos.m_publishMode.kind = rmw_fastrtps_shared_cpp::get_publish_mode(service_name);
     publisherParam.historyMemoryPolicy =
       eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
   }
@@ -180,6 +182,7 @@ rmw_create_client(
   publisherParam.topic.topicDataType = request_type_name;
   publisherParam.topic.topicName = _create_topic_name(
     qos_policies, ros_service_requester_prefix, service_name, "Request");
+  publisherParam.qos.m_userData.setDataVec(impl->endpoint_user_data);
 
   RCUTILS_LOG_DEBUG_NAMED(
     "rmw_fastrtps_dynamic_cpp",
@@ -21,8 +21,10 @@
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
 #include "rmw_fastrtps_shared_cpp/guid_utils.hpp"
+#include "rmw_fastrtps_shared_cpp/history_memory_policy.hpp"
 #include "rmw_fastrtps_shared_cpp/names.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
+#include "rmw_fastrtps_shared_cpp/publish_mode.hpp"
 #include "rmw_fastrtps_shared_cpp/qos.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 
@@ -137,7 +139,7 @@ rmw_create_publisher(
   }
 
   TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
-  auto type_impl = type_registry.get_message_type_support(type_support);
+  auto type_impl = type_registry.get_message_type_support(type_support, type_supports);
   if (!type_impl) {
     delete info;
     RMW_SET_ERROR_MSG("failed to allocate type support");
@@ -162,14 +164,35 @@ rmw_create_publisher(
   }
 
   if (!impl->leave_middleware_default_qos) {
-    publisherParam.qos.m_publishMode.kind = eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE;
-    publisherParam.historyMemoryPolicy =
-      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+    // The payloads are preallocated with the size of the registered type, which may come from
+    // another type support than the one serializing the samples of this topic
+    const bool fits_preallocated =
+      type_impl->is_bounded() && info->type_support_->m_typeSize >= type_impl->m_typeSize;
+    publisherParam.qos.m_publishMode.kind = rmw_fastrtps_shared_cpp::get_publish_mode(topic_name);
+    publisherParam.historyMemoryPolicy = rmw_fastrtps_shared_cpp::get_history_memory_policy(
+      topic_name, fits_preallocated, info->type_support_->m_typeSize);
+
+    // Grow the payloads of unbounded types to the recent high water mark at once
+    uint32_t window = rmw_fastrtps_shared_cpp::get_payload_sizing_window();
+    if (
+      window != 0 && !type_impl->is_bounded() &&
+      publisherParam.historyMemoryPolicy ==
+      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE)
+    {
+      info->payload_sizing_.reset(
+        new (std::nothrow) rmw_fastrtps_shared_cpp::PayloadSizing(
+          info->type_support_->m_typeSize, window));
+      if (!info->payload_sizing_) {
+        RMW_SET_ERROR_MSG("failed to allocate payload sizing");
+        goto fail;
+      }
+    }
   }
 
   publisherParam.topic.topicKind = eprosima::fastrtps::rtps::NO_KEY;
   publisherParam.topic.topicDataType = type_name;
   publisherParam.topic.topicName = _create_topic_name(qos_policies, ros_topic_prefix, topic_name);
+  publisherParam.qos.m_userData.setDataVec(impl->endpoint_user_data);
 
   // 1 Heartbeat every 10ms
   // publisherParam.times.heartbeatPeriod.seconds = 0;
@@ -239,7 +262,7 @@ fail:
     delete info;
   }
 
-  type_registry.return_message_type_support(type_support);
+  type_registry.return_message_type_support(type_impl);
 
   if (rmw_publisher) {
     rmw_publisher_free(rmw_publisher);
@@ -309,11 +332,8 @@ rmw_destroy_publisher(rmw_node_t * node, rmw_publisher_t * publisher)
   auto impl = static_cast<const BaseTypeSupport *>(info->type_support_impl_);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(impl, "publisher type support is null", return RMW_RET_ERROR);
 
-  auto ros_type_support = static_cast<const rosidl_message_type_support_t *>(
-    impl->ros_type_support());
-
   TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
-  type_registry.return_message_type_support(ros_type_support);
+  type_registry.return_message_type_support(impl);
 
   return rmw_fastrtps_shared_cpp::__rmw_destroy_publisher(
     eprosima_fastrtps_identifier, node, publisher);
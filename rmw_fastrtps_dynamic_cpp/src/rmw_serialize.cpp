@@ -41,12 +41,14 @@ rmw_serialize(
   }
 
   TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
-  auto tss = type_registry.get_message_type_support(ts);
+  auto tss = type_registry.get_thread_message_type_support(ts, type_support);
+  if (!tss) {
+    return RMW_RET_ERROR;
+  }
   auto data_length = tss->getEstimatedSerializedSize(ros_message, ts->data);
   if (serialized_message->buffer_capacity < data_length) {
     if (rmw_serialized_message_resize(serialized_message, data_length) != RMW_RET_OK) {
       RMW_SET_ERROR_MSG("unable to dynamically resize serialized message");
-      type_registry.return_message_type_support(ts);
       return RMW_RET_ERROR;
     }
   }
@@ -60,7 +62,6 @@ rmw_serialize(
   auto ret = tss->serializeROSmessage(ros_message, ser, ts->data);
   serialized_message->buffer_length = data_length;
   serialized_message->buffer_capacity = data_length;
-  type_registry.return_message_type_support(ts);
   return ret == true ? RMW_RET_OK : RMW_RET_ERROR;
 }
 
@@ -82,24 +83,53 @@ rmw_deserialize(
   }
 
   TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
-  auto tss = type_registry.get_message_type_support(ts);
+  auto tss = type_registry.get_thread_message_type_support(ts, type_support);
+  if (!tss) {
+    return RMW_RET_ERROR;
+  }
   eprosima::fastcdr::FastBuffer buffer(
     reinterpret_cast<char *>(serialized_message->buffer), serialized_message->buffer_length);
   eprosima::fastcdr::Cdr deser(buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
     eprosima::fastcdr::Cdr::DDS_CDR);
 
   auto ret = tss->deserializeROSmessage(deser, ros_message, ts->data);
-  type_registry.return_message_type_support(ts);
   return ret == true ? RMW_RET_OK : RMW_RET_ERROR;
 }
 
 rmw_ret_t
 rmw_get_serialized_message_size(
-  const rosidl_message_type_support_t * /*type_support*/,
-  const rosidl_message_bounds_t * /*message_bounds*/,
-  size_t * /*size*/)
+  const rosidl_message_type_support_t * type_support,
+  const rosidl_message_bounds_t * message_bounds,
+  size_t * size)
 {
-  RMW_SET_ERROR_MSG("unimplemented");
-  return RMW_RET_ERROR;
+  RMW_CHECK_ARGUMENT_FOR_NULL(type_support, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(size, RMW_RET_INVALID_ARGUMENT);
+  // Message bounds carry no information yet, only bounded types have a maximum size
+  (void)message_bounds;
+
+  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
+    type_support, rosidl_typesupport_introspection_c__identifier);
+  if (!ts) {
+    ts = get_message_typesupport_handle(
+      type_support, rosidl_typesupport_introspection_cpp::typesupport_identifier);
+    if (!ts) {
+      RMW_SET_ERROR_MSG("type support not from this implementation");
+      return RMW_RET_ERROR;
+    }
+  }
+
+  TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
+  auto tss = type_registry.get_thread_message_type_support(ts, type_support);
+  if (!tss) {
+    return RMW_RET_ERROR;
+  }
+  if (!tss->is_bounded()) {
+    RMW_SET_ERROR_MSG("message type is unbounded, its serialized size has no maximum");
+    return RMW_RET_ERROR;
+  }
+
+  // Includes the encapsulation header, as serialized by rmw_serialize
+  *size = tss->m_typeSize;
+  return RMW_RET_OK;
 }
 }  // extern "C"
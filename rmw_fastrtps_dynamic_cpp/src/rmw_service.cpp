@@ -39,6 +39,7 @@
 #include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
 #include "rmw_fastrtps_shared_cpp/names.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
+#include "rmw_fastrtps_shared_cpp/publish_mode.hpp"
 #include "rmw_fastrtps_shared_cpp/qos.hpp"
 
 #include "rmw_fastrtps_dynamic_cpp/identifier.hpp"
@@ -178,9 +179,10 @@ rmw_create_service(
   subscriberParam.topic.topicDataType = request_type_name;
   subscriberParam.topic.topicName = _create_topic_name(
     qos_policies, ros_service_requester_prefix, service_name, "Request");
+  subscriberParam.qos.m_userData.setDataVec(impl->endpoint_user_data);
 
   if (!impl->leave_middleware_default_qos) {
-    publisherParam.qos.m_publishMode.kind = eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE;
+    publisherParam.qos.m_publishMode.kind = rmw_fastrtps_shared_cpp::get_publish_mode(service_name);
     publisherParam.historyMemoryPolicy =
       eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
   }
@@ -189,6 +191,7 @@ rmw_create_service(
   publisherParam.topic.topicDataType = response_type_name;
   publisherParam.topic.topicName = _create_topic_name(
     qos_policies, ros_service_response_prefix, service_name, "Reply");
+  publisherParam.qos.m_userData.setDataVec(impl->endpoint_user_data);
 
   RCUTILS_LOG_DEBUG_NAMED(
     "rmw_fastrtps_dynamic_cpp",
@@ -21,6 +21,7 @@
 
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/history_memory_policy.hpp"
 #include "rmw_fastrtps_shared_cpp/names.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 #include "rmw_fastrtps_shared_cpp/qos.hpp"
@@ -31,6 +32,7 @@
 
 #include "rmw_fastrtps_dynamic_cpp/identifier.hpp"
 
+#include "loaned_message.hpp"
 #include "type_support_common.hpp"
 #include "type_support_registry.hpp"
 
@@ -138,8 +140,15 @@ rmw_create_subscription(
     return nullptr;
   }
 
+  // Loaned C messages may point into the received sample, which needs introspection
+  size_t sequence_view_min_size = 0;
+  const bool loan_messages =
+    using_introspection_c_typesupport(type_support->typesupport_identifier) &&
+    get_sequence_view_min_size(sequence_view_min_size);
+
   TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
-  auto type_impl = type_registry.get_message_type_support(type_support);
+  auto type_impl = type_registry.get_message_type_support(
+    type_support, loan_messages ? nullptr : type_supports);
   if (!type_impl) {
     delete info;
     RMW_SET_ERROR_MSG("failed to allocate type support");
@@ -164,13 +173,18 @@ rmw_create_subscription(
   }
 
   if (!impl->leave_middleware_default_qos) {
-    subscriberParam.historyMemoryPolicy =
-      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+    // The payloads are preallocated with the size of the registered type, which may come from
+    // another type support than the one serializing the samples of this topic
+    const bool fits_preallocated =
+      type_impl->is_bounded() && info->type_support_->m_typeSize >= type_impl->m_typeSize;
+    subscriberParam.historyMemoryPolicy = rmw_fastrtps_shared_cpp::get_history_memory_policy(
+      topic_name, fits_preallocated, info->type_support_->m_typeSize);
   }
 
   subscriberParam.topic.topicKind = eprosima::fastrtps::rtps::NO_KEY;
   subscriberParam.topic.topicDataType = type_name;
   subscriberParam.topic.topicName = _create_topic_name(qos_policies, ros_topic_prefix, topic_name);
+  subscriberParam.qos.m_userData.setDataVec(impl->endpoint_user_data);
 
   if (!get_datareader_qos(*qos_policies, subscriberParam)) {
     RMW_SET_ERROR_MSG("failed to get datareader qos");
@@ -207,7 +221,7 @@ rmw_create_subscription(
   memcpy(const_cast<char *>(rmw_subscription->topic_name), topic_name, strlen(topic_name) + 1);
 
   rmw_subscription->options = *subscription_options;
-  rmw_subscription->can_loan_messages = false;
+  rmw_subscription->can_loan_messages = loan_messages;
   return rmw_subscription;
 
 fail:
@@ -222,7 +236,7 @@ fail:
     delete info;
   }
 
-  type_registry.return_message_type_support(type_support);
+  type_registry.return_message_type_support(type_impl);
 
   if (rmw_subscription) {
     rmw_subscription_free(rmw_subscription);
@@ -258,11 +272,8 @@ rmw_destroy_subscription(rmw_node_t * node, rmw_subscription_t * subscription)
   auto impl = static_cast<const BaseTypeSupport *>(info->type_support_impl_);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(impl, "publisher type support is null", return RMW_RET_ERROR);
 
-  auto ros_type_support = static_cast<const rosidl_message_type_support_t *>(
-    impl->ros_type_support());
-
   TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
-  type_registry.return_message_type_support(ros_type_support);
+  type_registry.return_message_type_support(impl);
 
   return rmw_fastrtps_shared_cpp::__rmw_destroy_subscription(
     eprosima_fastrtps_identifier, node, subscription);
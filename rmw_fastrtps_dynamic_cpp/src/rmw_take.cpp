@@ -21,6 +21,8 @@
 
 #include "rmw_fastrtps_dynamic_cpp/identifier.hpp"
 
+#include "loaned_message.hpp"
+
 extern "C"
 {
 rmw_ret_t
@@ -77,13 +79,8 @@ rmw_take_loaned_message(
   bool * taken,
   rmw_subscription_allocation_t * allocation)
 {
-  (void) subscription;
-  (void) loaned_message;
-  (void) taken;
   (void) allocation;
-
-  RMW_SET_ERROR_MSG("rmw_take_loaned_message is not implemented for rmw_fastrtps_dynamic_cpp");
-  return RMW_RET_UNSUPPORTED;
+  return take_loaned_message(subscription, loaned_message, taken, nullptr);
 }
 
 rmw_ret_t
@@ -94,15 +91,9 @@ rmw_take_loaned_message_with_info(
   rmw_message_info_t * message_info,
   rmw_subscription_allocation_t * allocation)
 {
-  (void) subscription;
-  (void) loaned_message;
-  (void) taken;
-  (void) message_info;
   (void) allocation;
-
-  RMW_SET_ERROR_MSG(
-    "rmw_take_loaned_message_with_info is not implemented for rmw_fastrtps_dynamic_cpp");
-  return RMW_RET_UNSUPPORTED;
+  RMW_CHECK_ARGUMENT_FOR_NULL(message_info, RMW_RET_INVALID_ARGUMENT);
+  return take_loaned_message(subscription, loaned_message, taken, message_info);
 }
 
 rmw_ret_t
@@ -110,12 +101,7 @@ rmw_return_loaned_message_from_subscription(
   const rmw_subscription_t * subscription,
   void * loaned_message)
 {
-  (void) subscription;
-  (void) loaned_message;
-
-  RMW_SET_ERROR_MSG(
-    "rmw_return_loaned_message_from_subscription is not implemented for rmw_fastrtps_dynamic_cpp");
-  return RMW_RET_UNSUPPORTED;
+  return return_loaned_message(subscription, loaned_message);
 }
 
 rmw_ret_t
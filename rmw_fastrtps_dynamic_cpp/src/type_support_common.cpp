@@ -20,6 +20,9 @@
 
 #include "rosidl_typesupport_introspection_c/identifier.h"
 
+#include "rosidl_typesupport_fastrtps_c/identifier.h"
+#include "rosidl_typesupport_fastrtps_cpp/identifier.hpp"
+
 #include "type_support_common.hpp"
 
 bool
@@ -35,6 +38,21 @@ using_introspection_cpp_typesupport(const char * typesupport_identifier)
          rosidl_typesupport_introspection_cpp::typesupport_identifier;
 }
 
+const rosidl_message_type_support_t *
+get_generated_message_typesupport_handle(
+  const rosidl_message_type_support_t * type_supports,
+  const char * typesupport_identifier)
+{
+  if (using_introspection_c_typesupport(typesupport_identifier)) {
+    return get_message_typesupport_handle(
+      type_supports, rosidl_typesupport_fastrtps_c__identifier);
+  } else if (using_introspection_cpp_typesupport(typesupport_identifier)) {
+    return get_message_typesupport_handle(
+      type_supports, rosidl_typesupport_fastrtps_cpp::typesupport_identifier);
+  }
+  return nullptr;
+}
+
 void
 _register_type(
   eprosima::fastrtps::Participant * participant,
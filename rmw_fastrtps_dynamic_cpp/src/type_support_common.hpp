@@ -27,6 +27,7 @@
 
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
+#include "rmw_fastrtps_dynamic_cpp/GeneratedMessageTypeSupport.hpp"
 #include "rmw_fastrtps_dynamic_cpp/MessageTypeSupport.hpp"
 #include "rmw_fastrtps_dynamic_cpp/ServiceTypeSupport.hpp"
 
@@ -71,6 +72,18 @@ using_introspection_c_typesupport(const char * typesupport_identifier);
 bool
 using_introspection_cpp_typesupport(const char * typesupport_identifier);
 
+/// Find the code generated by rosidl_typesupport_fastrtps_c/cpp for a message type.
+/**
+ * \param type_supports handle the introspection type support was resolved from.
+ * \param typesupport_identifier identifier of that introspection type support, the generated
+ *   type support must share its message memory layout (C or C++).
+ * \return the generated type support, or nullptr if it is not available for this type.
+ */
+const rosidl_message_type_support_t *
+get_generated_message_typesupport_handle(
+  const rosidl_message_type_support_t * type_supports,
+  const char * typesupport_identifier);
+
 template<typename MembersType>
 ROSIDL_TYPESUPPORT_INTROSPECTION_CPP_LOCAL
 inline std::string
@@ -23,6 +23,30 @@ TypeSupportProxy::TypeSupportProxy(rmw_fastrtps_shared_cpp::TypeSupport * inner_
   m_typeSize = inner_type->m_typeSize;
 }
 
+// The type support of a sample, nullptr for serialized messages and retained payloads.
+static const rmw_fastrtps_shared_cpp::TypeSupport * inner_type_of(void * data)
+{
+  return static_cast<const rmw_fastrtps_shared_cpp::TypeSupport *>(
+    static_cast<rmw_fastrtps_shared_cpp::SerializedData *>(data)->impl);
+}
+
+bool TypeSupportProxy::serialize(
+  void * data, eprosima::fastrtps::rtps::SerializedPayload_t * payload)
+{
+  return rmw_fastrtps_shared_cpp::TypeSupport::serialize(inner_type_of(data), data, payload);
+}
+
+bool TypeSupportProxy::deserialize(
+  eprosima::fastrtps::rtps::SerializedPayload_t * payload, void * data)
+{
+  return rmw_fastrtps_shared_cpp::TypeSupport::deserialize(inner_type_of(data), payload, data);
+}
+
+std::function<uint32_t()> TypeSupportProxy::getSerializedSizeProvider(void * data)
+{
+  return rmw_fastrtps_shared_cpp::TypeSupport::getSerializedSizeProvider(inner_type_of(data), data);
+}
+
 size_t TypeSupportProxy::getEstimatedSerializedSize(
   const void * ros_message, const void * impl) const
 {
@@ -12,10 +12,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
 #include "rcutils/logging_macros.h"
 
 #include "rmw/error_handling.h"
 
+#include "rmw_fastrtps_shared_cpp/env.hpp"
+
 #include "type_support_common.hpp"
 #include "type_support_registry.hpp"
 
@@ -26,26 +33,28 @@ type_support_ptr get_type_support(
   std::lock_guard<std::mutex> guard(map.getMutex());
   RefCountedTypeSupport & item = map()[ros_type_support];
   if (0 == item.ref_count++) {
-    item.type_support = fun();
+    item.type_support.reset(fun());
     if (!item.type_support) {
       map().erase(ros_type_support);
       return nullptr;
     }
   }
-  return item.type_support;
+  return item.type_support.get();
 }
 
+/// \return whether the type support was released.
 template<typename key_type, typename map_type>
-void return_type_support(
+bool return_type_support(
   const key_type & ros_type_support, map_type & map)
 {
   std::lock_guard<std::mutex> guard(map.getMutex());
   auto it = map().find(ros_type_support);
   assert(it != map().end());
   if (0 == --it->second.ref_count) {
-    delete it->second.type_support;
     map().erase(it);
+    return true;
   }
+  return false;
 }
 
 template<typename map_type>
@@ -56,16 +65,90 @@ void cleanup(map_type & map, const char * msg)
     RCUTILS_LOG_DEBUG_NAMED(
       "rmw_fastrtps_dynamic_cpp",
       "TypeSupportRegistry %s is not empty. Cleaning it up...", msg);
-    for (auto it : map() ) {
-      delete it.second.type_support;
-    }
     map().clear();
   }
 }
 
+namespace
+{
+
+/**
+ * A message type support cached by a thread, along with what its handles pointed to.
+ *
+ * The type of a handle which was never registered is never released, so if its library is
+ * unloaded and the address reused by another handle, this is the only way to tell.
+ */
+struct ThreadMessageType
+{
+  const void * data;
+  const void * type_supports_data;
+  std::shared_ptr<rmw_fastrtps_dynamic_cpp::BaseTypeSupport> type_support;
+};
+
+/**
+ * Message type supports used by one thread, valid for one generation of the registry.
+ */
+struct ThreadTypeSupportCache
+{
+  uint64_t generation = 0;
+  // Keyed by the arguments of get_thread_message_type_support()
+  std::map<
+    std::pair<const rosidl_message_type_support_t *, const rosidl_message_type_support_t *>,
+    ThreadMessageType> message_types;
+};
+
+bool read_use_generated_type_support()
+{
+  uint64_t use_generated = 1;
+  rmw_fastrtps_shared_cpp::get_env_uint(
+    "RMW_FASTRTPS_USE_GENERATED_TYPESUPPORT", 1,
+    "the generated code is used when available", use_generated);
+  return use_generated != 0;
+}
+
+const rosidl_message_type_support_t * find_generated_type_support(
+  const rosidl_message_type_support_t * ros_type_support,
+  const rosidl_message_type_support_t * type_supports)
+{
+  static const bool use_generated = read_use_generated_type_support();
+  if (!use_generated || !type_supports) {
+    return nullptr;
+  }
+  return get_generated_message_typesupport_handle(
+    type_supports, ros_type_support->typesupport_identifier);
+}
+
+type_support_ptr create_message_type_support(
+  const rosidl_message_type_support_t * ros_type_support,
+  const rosidl_message_type_support_t * generated_type_support)
+{
+  if (generated_type_support) {
+    auto callbacks = static_cast<const message_type_support_callbacks_t *>(
+      generated_type_support->data);
+    return new rmw_fastrtps_dynamic_cpp::GeneratedMessageTypeSupport(
+      callbacks,
+      _create_type_name(ros_type_support->data, ros_type_support->typesupport_identifier),
+      ros_type_support);
+  }
+  if (using_introspection_c_typesupport(ros_type_support->typesupport_identifier)) {
+    auto members = static_cast<const rosidl_typesupport_introspection_c__MessageMembers *>(
+      ros_type_support->data);
+    return new MessageTypeSupport_c(members, ros_type_support);
+  } else if (using_introspection_cpp_typesupport(ros_type_support->typesupport_identifier)) {
+    auto members = static_cast<const rosidl_typesupport_introspection_cpp::MessageMembers *>(
+      ros_type_support->data);
+    return new MessageTypeSupport_cpp(members, ros_type_support);
+  }
+  RMW_SET_ERROR_MSG("Unknown typesupport identifier");
+  return nullptr;
+}
+
+}  // namespace
+
 TypeSupportRegistry::~TypeSupportRegistry()
 {
   cleanup(message_types_, "message_types_");
+  cleanup(generated_message_types_, "generated_message_types_");
   cleanup(request_types_, "request_types_");
   cleanup(response_types_, "response_types_");
 }
@@ -77,24 +160,18 @@ TypeSupportRegistry & TypeSupportRegistry::get_instance()
 }
 
 type_support_ptr TypeSupportRegistry::get_message_type_support(
-  const rosidl_message_type_support_t * ros_type_support)
+  const rosidl_message_type_support_t * ros_type_support,
+  const rosidl_message_type_support_t * type_supports)
 {
-  auto creator_fun = [&ros_type_support]() -> type_support_ptr
+  const rosidl_message_type_support_t * generated_type_support =
+    find_generated_type_support(ros_type_support, type_supports);
+  auto creator_fun = [&ros_type_support, &generated_type_support]() -> type_support_ptr
     {
-      if (using_introspection_c_typesupport(ros_type_support->typesupport_identifier)) {
-        auto members = static_cast<const rosidl_typesupport_introspection_c__MessageMembers *>(
-          ros_type_support->data);
-        return new MessageTypeSupport_c(members, ros_type_support);
-      } else if (using_introspection_cpp_typesupport(ros_type_support->typesupport_identifier)) {
-        auto members = static_cast<const rosidl_typesupport_introspection_cpp::MessageMembers *>(
-          ros_type_support->data);
-        return new MessageTypeSupport_cpp(members, ros_type_support);
-      }
-      RMW_SET_ERROR_MSG("Unknown typesupport identifier");
-      return nullptr;
+      return create_message_type_support(ros_type_support, generated_type_support);
     };
 
-  return get_type_support(ros_type_support, message_types_, creator_fun);
+  return get_type_support(
+    ros_type_support, message_types(generated_type_support != nullptr), creator_fun);
 }
 
 type_support_ptr TypeSupportRegistry::get_request_type_support(
@@ -139,10 +216,68 @@ type_support_ptr TypeSupportRegistry::get_response_type_support(
   return get_type_support(ros_type_support, response_types_, creator_fun);
 }
 
+std::shared_ptr<rmw_fastrtps_dynamic_cpp::BaseTypeSupport>
+TypeSupportRegistry::get_thread_message_type_support(
+  const rosidl_message_type_support_t * ros_type_support,
+  const rosidl_message_type_support_t * type_supports)
+{
+  thread_local ThreadTypeSupportCache cache;
+  // A handle may belong to a library unloaded since, and its address be reused by another
+  const uint64_t generation = message_types_generation_.load();
+  if (cache.generation != generation) {
+    cache.message_types.clear();
+    cache.generation = generation;
+  }
+  const auto key = std::make_pair(ros_type_support, type_supports);
+  const void * type_supports_data = type_supports ? type_supports->data : nullptr;
+  auto it = cache.message_types.find(key);
+  if (it != cache.message_types.end()) {
+    if (it->second.data == ros_type_support->data &&
+      it->second.type_supports_data == type_supports_data)
+    {
+      return it->second.type_support;
+    }
+    cache.message_types.erase(it);
+  }
+
+  const rosidl_message_type_support_t * generated_type_support =
+    find_generated_type_support(ros_type_support, type_supports);
+  LockedObject<msg_map_t> & registered_types = message_types(generated_type_support != nullptr);
+  std::shared_ptr<rmw_fastrtps_dynamic_cpp::BaseTypeSupport> type_support;
+  {
+    std::lock_guard<std::mutex> guard(registered_types.getMutex());
+    auto registered = registered_types().find(ros_type_support);
+    if (registered != registered_types().end()) {
+      type_support = registered->second.type_support;
+    }
+  }
+  if (!type_support) {
+    type_support.reset(create_message_type_support(ros_type_support, generated_type_support));
+    if (!type_support) {
+      return nullptr;
+    }
+  }
+  cache.message_types.emplace(
+    key, ThreadMessageType{ros_type_support->data, type_supports_data, type_support});
+  return type_support;
+}
+
 void TypeSupportRegistry::return_message_type_support(
-  const rosidl_message_type_support_t * ros_type_support)
+  const rmw_fastrtps_dynamic_cpp::BaseTypeSupport * type_support)
+{
+  auto ros_type_support = static_cast<const rosidl_message_type_support_t *>(
+    type_support->ros_type_support());
+  const bool generated =
+    nullptr != dynamic_cast<const rmw_fastrtps_dynamic_cpp::GeneratedMessageTypeSupport *>(
+    type_support);
+  if (return_type_support(ros_type_support, message_types(generated))) {
+    ++message_types_generation_;
+  }
+}
+
+LockedObject<msg_map_t> & TypeSupportRegistry::message_types(bool generated)
 {
-  return_type_support(ros_type_support, message_types_);
+  return generated ? generated_message_types_ : message_types_;
 }
 
 void TypeSupportRegistry::return_request_type_support(
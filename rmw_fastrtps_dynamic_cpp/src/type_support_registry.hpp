@@ -15,6 +15,8 @@
 #ifndef TYPE_SUPPORT_REGISTRY_HPP_
 #define TYPE_SUPPORT_REGISTRY_HPP_
 
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 
 #include "rmw/rmw.h"
@@ -31,7 +33,7 @@ using type_support_ptr = rmw_fastrtps_dynamic_cpp::BaseTypeSupport *;
  */
 struct RefCountedTypeSupport
 {
-  type_support_ptr type_support = nullptr;
+  std::shared_ptr<rmw_fastrtps_dynamic_cpp::BaseTypeSupport> type_support;
   uint32_t ref_count = 0;
 };
 
@@ -41,19 +43,36 @@ using srv_map_t = std::unordered_map<const rosidl_service_type_support_t *, RefC
 class TypeSupportRegistry
 {
 private:
+  // Introspection and generated type supports of the same type are registered separately,
+  // each keyed by the introspection type support.
   LockedObject<msg_map_t> message_types_;
+  LockedObject<msg_map_t> generated_message_types_;
   LockedObject<srv_map_t> request_types_;
   LockedObject<srv_map_t> response_types_;
+  // Bumped every time a message type support is released by its last user.
+  std::atomic<uint64_t> message_types_generation_{0};
 
   TypeSupportRegistry() = default;
 
+  LockedObject<msg_map_t> & message_types(bool generated);
+
 public:
   ~TypeSupportRegistry();
 
   static TypeSupportRegistry & get_instance();
 
+  /// Get the type support of a message, creating it if it is not registered yet.
+  /**
+   * \param ros_type_support introspection type support of the message.
+   * \param type_supports handle ros_type_support was resolved from, when given the code
+   *   generated by rosidl_typesupport_fastrtps_c/cpp is preferred over introspection,
+   *   unless RMW_FASTRTPS_USE_GENERATED_TYPESUPPORT is set to 0.
+   *   Without it the type support always uses introspection, whatever other callers got.
+   * \return the type support, or nullptr if it could not be created.
+   */
   type_support_ptr get_message_type_support(
-    const rosidl_message_type_support_t * ros_type_support);
+    const rosidl_message_type_support_t * ros_type_support,
+    const rosidl_message_type_support_t * type_supports = nullptr);
 
   type_support_ptr get_request_type_support(
     const rosidl_service_type_support_t * ros_type_support);
@@ -61,14 +80,37 @@ public:
   type_support_ptr get_response_type_support(
     const rosidl_service_type_support_t * ros_type_support);
 
+  /// Return a type support got from get_message_type_support().
   void return_message_type_support(
-    const rosidl_message_type_support_t * ros_type_support);
+    const rmw_fastrtps_dynamic_cpp::BaseTypeSupport * type_support);
 
   void return_request_type_support(
     const rosidl_service_type_support_t * ros_type_support);
 
   void return_response_type_support(
     const rosidl_service_type_support_t * ros_type_support);
+
+  /// Get a message type support without taking the registry lock in the common case.
+  /**
+   * The type support registered for a publisher or subscription is shared, otherwise one is
+   * created for the calling thread.
+   * Either way it is cached in thread local storage, so only the first call for a given type
+   * on each thread reaches the shared maps.
+   * The cache does not keep registered type supports alive, it is dropped as soon as the last
+   * publisher or subscription of any message type is destroyed, so that handles of unloaded
+   * libraries are never looked up.
+   * A type support created for the calling thread is dropped as soon as its handles no longer
+   * point to the type they pointed to when it was created.
+   * It must not be returned with return_message_type_support().
+   *
+   * \param ros_type_support introspection type support of the message.
+   * \param type_supports see get_message_type_support().
+   * \return the type support, which the caller keeps alive while using it,
+   *   or nullptr if it could not be created.
+   */
+  std::shared_ptr<rmw_fastrtps_dynamic_cpp::BaseTypeSupport> get_thread_message_type_support(
+    const rosidl_message_type_support_t * ros_type_support,
+    const rosidl_message_type_support_t * type_supports = nullptr);
 };
 
 #endif  // TYPE_SUPPORT_REGISTRY_HPP_
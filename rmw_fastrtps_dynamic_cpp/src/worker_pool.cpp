@@ -0,0 +1,156 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "rmw_fastrtps_shared_cpp/env.hpp"
+
+#include "rmw_fastrtps_dynamic_cpp/worker_pool.hpp"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+WorkerPool & WorkerPool::get_instance()
+{
+  static WorkerPool pool;
+  return pool;
+}
+
+WorkerPool::WorkerPool()
+: worker_count_(std::thread::hardware_concurrency() > 1 ?
+    std::thread::hardware_concurrency() - 1 : 0)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  job_started_.notify_all();
+  for (auto & worker : workers_) {
+    worker.join();
+  }
+}
+
+void WorkerPool::parallel_for(size_t count, const std::function<void(size_t)> & task)
+{
+  job_count_.fetch_add(1, std::memory_order_relaxed);
+  std::unique_lock<std::mutex> job_lock(job_mutex_, std::try_to_lock);
+  if (!job_lock.owns_lock() || worker_count_ == 0 || count < 2) {
+    for (size_t i = 0; i < count; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  if (workers_.empty()) {
+    workers_.reserve(worker_count_);
+    for (size_t i = 0; i < worker_count_; ++i) {
+      workers_.emplace_back(&WorkerPool::worker_main, this);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    count_ = count;
+    next_.store(0);
+    pending_ = count;
+    ++generation_;
+  }
+  job_started_.notify_all();
+
+  run_tasks();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Workers still looping over the tasks would pick up the ones of the next job otherwise
+  job_done_.wait(lock, [this]() {return pending_ == 0 && active_workers_ == 0;});
+  task_ = nullptr;
+}
+
+void WorkerPool::run_tasks()
+{
+  size_t done = 0;
+  for (size_t i = next_.fetch_add(1); i < count_; i = next_.fetch_add(1)) {
+    (*task_)(i);
+    ++done;
+  }
+  if (done > 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_ -= done;
+    if (pending_ == 0) {
+      job_done_.notify_all();
+    }
+  }
+}
+
+void WorkerPool::worker_main()
+{
+  size_t seen_generation = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    job_started_.wait(
+      lock, [this, seen_generation]() {return stop_ || generation_ != seen_generation;});
+    if (stop_) {
+      return;
+    }
+    seen_generation = generation_;
+    // The job may be over already
+    if (!task_) {
+      continue;
+    }
+    ++active_workers_;
+    lock.unlock();
+    run_tasks();
+    lock.lock();
+    if (--active_workers_ == 0) {
+      job_done_.notify_all();
+    }
+  }
+}
+
+static size_t read_parallel_deserialization_min_size()
+{
+  uint64_t min_size = 0;
+  rmw_fastrtps_shared_cpp::get_env_uint(
+    "RMW_FASTRTPS_PARALLEL_DESERIALIZATION_MIN_SIZE", SIZE_MAX,
+    "arrays are not deserialized in parallel", min_size);
+  return static_cast<size_t>(min_size);
+}
+
+static std::atomic<size_t> & parallel_deserialization_min_size()
+{
+  static std::atomic<size_t> min_size{read_parallel_deserialization_min_size()};
+  return min_size;
+}
+
+size_t
+get_parallel_deserialization_min_size()
+{
+  return parallel_deserialization_min_size().load(std::memory_order_relaxed);
+}
+
+void
+set_parallel_deserialization_min_size(size_t min_size)
+{
+  parallel_deserialization_min_size().store(min_size, std::memory_order_relaxed);
+}
+
+}  // namespace rmw_fastrtps_dynamic_cpp
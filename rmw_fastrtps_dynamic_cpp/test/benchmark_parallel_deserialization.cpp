@@ -0,0 +1,145 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares deserializing a large array of fixed size messages on the calling thread against
+// deserializing it on the worker pool:
+//   benchmark_parallel_deserialization [elements] [iterations]
+// Defaults to 100k elements and 20 iterations.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+
+#include "rmw_fastrtps_dynamic_cpp/MessageTypeSupport.hpp"
+#include "rmw_fastrtps_dynamic_cpp/worker_pool.hpp"
+
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+#include "rosidl_typesupport_introspection_cpp/identifier.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+
+#include "test_helpers.hpp"
+
+using eprosima::fastcdr::Cdr;
+using eprosima::fastcdr::FastBuffer;
+using rosidl_typesupport_introspection_cpp::MessageMember;
+using rosidl_typesupport_introspection_cpp::MessageMembers;
+
+struct Point
+{
+  double x;
+  double y;
+  double z;
+  float intensity;
+  uint32_t ring;
+};
+
+struct PointCloud
+{
+  std::vector<Point> points;
+};
+
+int main(int argc, char ** argv)
+{
+  const size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000u;
+  const size_t iterations = argc > 2 ? strtoul(argv[2], nullptr, 10) : 20u;
+  if (count < 2u || iterations == 0u) {
+    fprintf(stderr, "usage: %s [elements] [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  using rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32;
+  using rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64;
+  using rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32;
+  std::vector<MessageMember> point_member_array{
+    make_member("x", ROS_TYPE_FLOAT64, offsetof(Point, x)),
+    make_member("y", ROS_TYPE_FLOAT64, offsetof(Point, y)),
+    make_member("z", ROS_TYPE_FLOAT64, offsetof(Point, z)),
+    make_member("intensity", ROS_TYPE_FLOAT32, offsetof(Point, intensity)),
+    make_member("ring", ROS_TYPE_UINT32, offsetof(Point, ring)),
+  };
+  MessageMembers point_members = make_members("Point", sizeof(Point), point_member_array);
+  rosidl_message_type_support_t point_ts{
+    rosidl_typesupport_introspection_cpp::typesupport_identifier, &point_members, nullptr};
+
+  std::vector<MessageMember> cloud_member_array{make_member(
+      "points", rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE,
+      offsetof(PointCloud, points), 0, &point_ts)};
+  MessageMember & points = cloud_member_array[0];
+  points.is_array_ = true;
+  points.size_function = [](const void * untyped_member) {
+      return static_cast<const std::vector<Point> *>(untyped_member)->size();
+    };
+  points.get_const_function = [](const void * untyped_member, size_t index) -> const void * {
+      return &(*static_cast<const std::vector<Point> *>(untyped_member))[index];
+    };
+  points.get_function = [](void * untyped_member, size_t index) -> void * {
+      return &(*static_cast<std::vector<Point> *>(untyped_member))[index];
+    };
+  points.resize_function = [](void * untyped_member, size_t size) {
+      static_cast<std::vector<Point> *>(untyped_member)->resize(size);
+    };
+  MessageMembers cloud_members =
+    make_members("PointCloud", sizeof(PointCloud), cloud_member_array);
+
+  rmw_fastrtps_dynamic_cpp::MessageTypeSupport<MessageMembers> type_support(
+    &cloud_members, nullptr);
+
+  PointCloud cloud;
+  cloud.points.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    cloud.points[i] = {0.5 * i, -0.5 * i, 0.25 * i, 1.0f, static_cast<uint32_t>(i % 64)};
+  }
+  std::vector<char> buffer(type_support.getEstimatedSerializedSize(&cloud, nullptr));
+  FastBuffer fast_buffer(buffer.data(), buffer.size());
+  Cdr ser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+  if (!type_support.serializeROSmessage(&cloud, ser, nullptr)) {
+    fprintf(stderr, "failed to serialize\n");
+    return 1;
+  }
+
+  auto deserialize = [&](PointCloud & result) {
+      Cdr deser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+      type_support.deserializeROSmessage(deser, &result, nullptr);
+    };
+
+  PointCloud sequential;
+  rmw_fastrtps_dynamic_cpp::set_parallel_deserialization_min_size(0);
+  double sequential_ms = best_ms(iterations, [&]() {deserialize(sequential);});
+
+  PointCloud parallel;
+  rmw_fastrtps_dynamic_cpp::set_parallel_deserialization_min_size(1);
+  double parallel_ms = best_ms(iterations, [&]() {deserialize(parallel);});
+
+  if (sequential.points.size() != count || parallel.points.size() != count ||
+    memcmp(sequential.points.data(), parallel.points.data(), count * sizeof(Point)) != 0)
+  {
+    fprintf(stderr, "deserialized points do not match\n");
+    return 1;
+  }
+
+  const double megabytes = ser.getSerializedDataLength() / 1e6;
+  printf(
+    "Point[%zu], %zu threads, best of %zu\n", count,
+    rmw_fastrtps_dynamic_cpp::WorkerPool::get_instance().concurrency(), iterations);
+  printf(
+    "  sequential  %8.3f ms  %8.1f MB/s\n", sequential_ms, megabytes / (sequential_ms / 1e3));
+  printf("  parallel    %8.3f ms  %8.1f MB/s\n", parallel_ms, megabytes / (parallel_ms / 1e3));
+  return 0;
+}
@@ -0,0 +1,142 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the cost per small message of going through the type registered in the participant,
+// as Fast-RTPS does on every publish and take, against using the message type support directly:
+//   benchmark_type_support_dispatch [messages] [iterations]
+// Defaults to 1M messages and 10 iterations.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+
+#include "fastrtps/rtps/common/SerializedPayload.h"
+
+#include "rmw_fastrtps_dynamic_cpp/MessageTypeSupport.hpp"
+#include "rmw_fastrtps_dynamic_cpp/TypeSupport.hpp"
+
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+
+#include "test_helpers.hpp"
+
+using eprosima::fastcdr::Cdr;
+using eprosima::fastcdr::FastBuffer;
+using eprosima::fastrtps::rtps::SerializedPayload_t;
+using rosidl_typesupport_introspection_cpp::MessageMember;
+using rosidl_typesupport_introspection_cpp::MessageMembers;
+
+// Not plain, the string is interpreted on every message
+struct Status
+{
+  uint8_t level;
+  int32_t code;
+  double stamp;
+  std::string name;
+};
+
+/// Run fun for each message the given number of times and return the best time per message.
+template<typename Function>
+static double best_ns_per_message(size_t iterations, size_t messages, Function fun)
+{
+  return best_ns(
+    iterations, [messages, &fun]() {
+      for (size_t i = 0; i < messages; ++i) {
+        fun();
+      }
+    }) / messages;
+}
+
+int main(int argc, char ** argv)
+{
+  const size_t messages = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000u;
+  const size_t iterations = argc > 2 ? strtoul(argv[2], nullptr, 10) : 10u;
+  if (messages == 0u || iterations == 0u) {
+    fprintf(stderr, "usage: %s [messages] [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  using rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64;
+  using rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32;
+  using rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING;
+  using rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8;
+  std::vector<MessageMember> member_array{
+    make_member("level", ROS_TYPE_UINT8, offsetof(Status, level)),
+    make_member("code", ROS_TYPE_INT32, offsetof(Status, code)),
+    make_member("stamp", ROS_TYPE_FLOAT64, offsetof(Status, stamp)),
+    make_member("name", ROS_TYPE_STRING, offsetof(Status, name)),
+  };
+  MessageMembers members = make_members("Status", sizeof(Status), member_array);
+
+  rmw_fastrtps_dynamic_cpp::MessageTypeSupport<MessageMembers> type_support(&members, nullptr);
+  rmw_fastrtps_dynamic_cpp::TypeSupportProxy proxy(&type_support);
+  // Fast-RTPS only knows the registered type through its base class
+  eprosima::fastrtps::TopicDataType * registered = &proxy;
+
+  Status status{2, -17, 1234.5, "motor_controller"};
+  rmw_fastrtps_shared_cpp::SerializedData data;
+  data.is_cdr_buffer = false;
+  data.data = &status;
+  data.impl = &type_support;
+
+  SerializedPayload_t payload(registered->getSerializedSizeProvider(&data)());
+  Status result;
+  rmw_fastrtps_shared_cpp::SerializedData result_data;
+  result_data.is_cdr_buffer = false;
+  result_data.data = &result;
+  result_data.impl = &type_support;
+
+  double direct_ns = best_ns_per_message(
+    iterations, messages, [&]() {
+      type_support.getEstimatedSerializedSize(&status, &type_support);
+      FastBuffer buffer(reinterpret_cast<char *>(payload.data), payload.max_size);
+      Cdr ser(buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+      type_support.serializeROSmessage(&status, ser, &type_support);
+      Cdr deser(buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+      type_support.deserializeROSmessage(deser, &result, &type_support);
+    });
+
+  // The implementation of the base class, which goes through the ROS message methods of the
+  // proxy before reaching the message type support
+  double through_proxy_ns = best_ns_per_message(
+    iterations, messages, [&]() {
+      proxy.rmw_fastrtps_shared_cpp::TypeSupport::getSerializedSizeProvider(&data)();
+      proxy.rmw_fastrtps_shared_cpp::TypeSupport::serialize(&data, &payload);
+      proxy.rmw_fastrtps_shared_cpp::TypeSupport::deserialize(&payload, &result_data);
+    });
+
+  double registered_ns = best_ns_per_message(
+    iterations, messages, [&]() {
+      registered->getSerializedSizeProvider(&data)();
+      registered->serialize(&data, &payload);
+      registered->deserialize(&payload, &result_data);
+    });
+
+  if (result.code != status.code || result.name != status.name) {
+    fprintf(stderr, "deserialized message does not match\n");
+    return 1;
+  }
+
+  printf("Status, %zu bytes, best of %zu\n", static_cast<size_t>(payload.length), iterations);
+  printf("  interpreter only        %8.1f ns/message\n", direct_ns);
+  printf("  through the proxy       %8.1f ns/message\n", through_proxy_ns);
+  printf("  registered type         %8.1f ns/message\n", registered_ns);
+  return 0;
+}
@@ -0,0 +1,154 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+#include "fastcdr/exceptions/NotEnoughMemoryException.h"
+
+#include "rmw_fastrtps_dynamic_cpp/MessageTypeSupport.hpp"
+
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+
+#include "test_helpers.hpp"
+
+using eprosima::fastcdr::Cdr;
+using eprosima::fastcdr::FastBuffer;
+using eprosima::fastcdr::exception::NotEnoughMemoryException;
+using rosidl_typesupport_introspection_cpp::MessageMember;
+using rosidl_typesupport_introspection_cpp::MessageMembers;
+
+using TypeSupport_cpp = rmw_fastrtps_dynamic_cpp::MessageTypeSupport<MessageMembers>;
+
+struct Labels
+{
+  std::string name;
+  std::string aliases[2];
+  std::vector<std::string> tags;
+  std::vector<double> values;
+};
+
+class DeserializeInPlaceTest : public ::testing::Test
+{
+public:
+  DeserializeInPlaceTest()
+  {
+    member_array[2].is_array_ = true;
+    member_array[3].is_array_ = true;
+  }
+
+  /// Serialize a message and deserialize it into result.
+  void take(const Labels & message, Labels & result)
+  {
+    std::vector<char> buffer(type_support.getEstimatedSerializedSize(&message, nullptr));
+    FastBuffer fast_buffer(buffer.data(), buffer.size());
+    Cdr ser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+    ASSERT_TRUE(type_support.serializeROSmessage(&message, ser, nullptr));
+
+    Cdr deser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+    ASSERT_TRUE(type_support.deserializeROSmessage(deser, &result, nullptr));
+    EXPECT_EQ(ser.getSerializedDataLength(), deser.getSerializedDataLength());
+  }
+
+  const uint8_t STRING = rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING;
+  const uint8_t DOUBLE = rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64;
+
+  std::vector<MessageMember> member_array{
+    make_member("name", STRING, offsetof(Labels, name)),
+    make_member("aliases", STRING, offsetof(Labels, aliases), 2),
+    make_member("tags", STRING, offsetof(Labels, tags)),
+    make_member("values", DOUBLE, offsetof(Labels, values)),
+  };
+  MessageMembers members = make_members("Labels", sizeof(Labels), member_array);
+  TypeSupport_cpp type_support{&members, nullptr};
+};
+
+TEST_F(DeserializeInPlaceTest, second_take_keeps_capacity) {
+  // Longer than the small string optimization buffer of any standard library
+  Labels large;
+  large.name = std::string(100, 'n');
+  large.aliases[0] = std::string(80, 'a');
+  large.aliases[1] = std::string(90, 'b');
+  large.tags = {std::string(70, 't'), std::string(60, 'u'), std::string(50, 'v')};
+  large.values = std::vector<double>(64, 1.5);
+
+  Labels small;
+  small.name = "first";
+  small.aliases[0] = "";
+  small.aliases[1] = "second";
+  small.tags = {"third", "fourth"};
+  small.values = {-2.0, 3.0};
+
+  Labels result;
+  take(large, result);
+  EXPECT_EQ(large.name, result.name);
+  EXPECT_EQ(large.aliases[0], result.aliases[0]);
+  EXPECT_EQ(large.aliases[1], result.aliases[1]);
+  EXPECT_EQ(large.tags, result.tags);
+  EXPECT_EQ(large.values, result.values);
+
+  const char * name_data = result.name.data();
+  const size_t name_capacity = result.name.capacity();
+  const size_t alias_capacity = result.aliases[1].capacity();
+  const std::string * tags_data = result.tags.data();
+  const size_t tags_capacity = result.tags.capacity();
+  const size_t tag_capacity = result.tags[1].capacity();
+  const double * values_data = result.values.data();
+  const size_t values_capacity = result.values.capacity();
+
+  take(small, result);
+  EXPECT_EQ(small.name, result.name);
+  EXPECT_EQ(small.aliases[0], result.aliases[0]);
+  EXPECT_EQ(small.aliases[1], result.aliases[1]);
+  EXPECT_EQ(small.tags, result.tags);
+  EXPECT_EQ(small.values, result.values);
+
+  EXPECT_EQ(name_data, result.name.data());
+  EXPECT_EQ(name_capacity, result.name.capacity());
+  EXPECT_EQ(alias_capacity, result.aliases[1].capacity());
+  EXPECT_EQ(tags_data, result.tags.data());
+  EXPECT_EQ(tags_capacity, result.tags.capacity());
+  EXPECT_EQ(tag_capacity, result.tags[1].capacity());
+  EXPECT_EQ(values_data, result.values.data());
+  EXPECT_EQ(values_capacity, result.values.capacity());
+}
+
+TEST_F(DeserializeInPlaceTest, string_longer_than_the_buffer) {
+  Labels message;
+  message.name = "name";
+  std::vector<char> buffer(type_support.getEstimatedSerializedSize(&message, nullptr));
+  FastBuffer fast_buffer(buffer.data(), buffer.size());
+  Cdr ser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+  ASSERT_TRUE(type_support.serializeROSmessage(&message, ser, nullptr));
+
+  // The length of the name follows the encapsulation
+  const uint32_t lengths[] = {0xFFFFFFFFu, static_cast<uint32_t>(buffer.size())};
+  for (uint32_t length : lengths) {
+    memcpy(buffer.data() + 4, &length, sizeof(length));
+    Labels result;
+    Cdr deser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+    EXPECT_THROW(
+      type_support.deserializeROSmessage(deser, &result, nullptr), NotEnoughMemoryException);
+    // Failed before growing the string to the announced length
+    EXPECT_GT(length, result.name.capacity());
+  }
+}
@@ -0,0 +1,244 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+
+#include "rmw_fastrtps_dynamic_cpp/GeneratedMessageTypeSupport.hpp"
+
+#include "rosidl_typesupport_fastrtps_cpp/identifier.hpp"
+#include "rosidl_typesupport_fastrtps_cpp/message_type_support.h"
+
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+#include "rosidl_typesupport_introspection_cpp/identifier.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+
+#include "../src/type_support_registry.hpp"
+
+#include "test_helpers.hpp"
+
+using eprosima::fastcdr::Cdr;
+using eprosima::fastcdr::FastBuffer;
+using rmw_fastrtps_dynamic_cpp::BaseTypeSupport;
+using rmw_fastrtps_dynamic_cpp::GeneratedMessageTypeSupport;
+using rosidl_typesupport_introspection_cpp::MessageMember;
+using rosidl_typesupport_introspection_cpp::MessageMembers;
+
+struct Sample
+{
+  uint8_t flag;
+  int32_t id;
+  std::string name;
+  std::vector<double> values;
+};
+
+// What rosidl_typesupport_fastrtps_cpp generates for Sample
+static bool cdr_serialize(const void * untyped_ros_message, Cdr & cdr)
+{
+  auto & ros_message = *static_cast<const Sample *>(untyped_ros_message);
+  cdr << ros_message.flag;
+  cdr << ros_message.id;
+  cdr << ros_message.name;
+  cdr << ros_message.values;
+  return true;
+}
+
+static bool cdr_deserialize(Cdr & cdr, void * untyped_ros_message)
+{
+  auto & ros_message = *static_cast<Sample *>(untyped_ros_message);
+  cdr >> ros_message.flag;
+  cdr >> ros_message.id;
+  cdr >> ros_message.name;
+  cdr >> ros_message.values;
+  return true;
+}
+
+static uint32_t get_serialized_size(const void * untyped_ros_message)
+{
+  auto & ros_message = *static_cast<const Sample *>(untyped_ros_message);
+  size_t current_alignment = 1;
+  current_alignment += 3 + 4;
+  current_alignment += 4 + ros_message.name.size() + 1;
+  current_alignment += Cdr::alignment(current_alignment, 4) + 4;
+  current_alignment += Cdr::alignment(current_alignment, 8) + 8 * ros_message.values.size();
+  return static_cast<uint32_t>(current_alignment);
+}
+
+static size_t max_serialized_size(bool & full_bounded)
+{
+  full_bounded = false;
+  return 1 + 3 + 4 + 4 + 1 + 3 + 4;
+}
+
+static const rosidl_message_type_support_t * get_sample_handle(
+  const rosidl_message_type_support_t * handle, const char * identifier);
+
+class GeneratedTypeSupportTest : public ::testing::Test
+{
+public:
+  std::vector<MessageMember> member_array{
+    make_member("flag", rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8,
+      offsetof(Sample, flag)),
+    make_member("id", rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32,
+      offsetof(Sample, id)),
+    make_member("name", rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING,
+      offsetof(Sample, name)),
+    make_member("values", rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64,
+      offsetof(Sample, values)),
+  };
+  MessageMembers members = make_members("Sample", sizeof(Sample), member_array);
+
+  message_type_support_callbacks_t callbacks{
+    "test_msgs::msg", "Sample",
+    cdr_serialize, cdr_deserialize, get_serialized_size, max_serialized_size};
+
+  rosidl_message_type_support_t introspection_ts{
+    rosidl_typesupport_introspection_cpp::typesupport_identifier, &members, nullptr};
+  rosidl_message_type_support_t generated_ts{
+    rosidl_typesupport_fastrtps_cpp::typesupport_identifier, &callbacks, nullptr};
+  // What rosidl_typesupport_cpp hands to the rmw, resolving both of the above
+  rosidl_message_type_support_t type_supports{"test_typesupport", this, get_sample_handle};
+
+  GeneratedTypeSupportTest()
+  {
+    member_array[3].is_array_ = true;
+  }
+};
+
+static const rosidl_message_type_support_t * get_sample_handle(
+  const rosidl_message_type_support_t * handle, const char * identifier)
+{
+  auto test = static_cast<const GeneratedTypeSupportTest *>(handle->data);
+  if (!strcmp(identifier, test->introspection_ts.typesupport_identifier)) {
+    return &test->introspection_ts;
+  }
+  if (!strcmp(identifier, test->generated_ts.typesupport_identifier)) {
+    return &test->generated_ts;
+  }
+  return nullptr;
+}
+
+static std::vector<char> serialize(const BaseTypeSupport * type_support, const Sample & sample)
+{
+  std::vector<char> buffer(type_support->getEstimatedSerializedSize(&sample, nullptr));
+  FastBuffer fast_buffer(buffer.data(), buffer.size());
+  Cdr ser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+  EXPECT_TRUE(type_support->serializeROSmessage(&sample, ser, nullptr));
+  buffer.resize(ser.getSerializedDataLength());
+  return buffer;
+}
+
+static Sample deserialize(const BaseTypeSupport * type_support, std::vector<char> buffer)
+{
+  Sample sample{};
+  FastBuffer fast_buffer(buffer.data(), buffer.size());
+  Cdr deser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+  EXPECT_TRUE(type_support->deserializeROSmessage(deser, &sample, nullptr));
+  return sample;
+}
+
+static void expect_equal(const Sample & expected, const Sample & actual)
+{
+  EXPECT_EQ(expected.flag, actual.flag);
+  EXPECT_EQ(expected.id, actual.id);
+  EXPECT_EQ(expected.name, actual.name);
+  EXPECT_EQ(expected.values, actual.values);
+}
+
+TEST_F(GeneratedTypeSupportTest, registry_keys_on_generated_or_not) {
+  TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
+
+  // Whichever is asked for first, the other one is still what its caller asked for
+  for (bool generated_first : {true, false}) {
+    BaseTypeSupport * generated = nullptr;
+    BaseTypeSupport * introspected = nullptr;
+    if (generated_first) {
+      generated = type_registry.get_message_type_support(&introspection_ts, &type_supports);
+      introspected = type_registry.get_message_type_support(&introspection_ts);
+    } else {
+      introspected = type_registry.get_message_type_support(&introspection_ts);
+      generated = type_registry.get_message_type_support(&introspection_ts, &type_supports);
+    }
+    ASSERT_NE(nullptr, generated);
+    ASSERT_NE(nullptr, introspected);
+    EXPECT_NE(nullptr, dynamic_cast<GeneratedMessageTypeSupport *>(generated));
+    EXPECT_EQ(nullptr, dynamic_cast<GeneratedMessageTypeSupport *>(introspected));
+    EXPECT_STREQ(generated->getName(), introspected->getName());
+
+    // Both are shared by further users of the same kind
+    EXPECT_EQ(introspected, type_registry.get_message_type_support(&introspection_ts));
+    type_registry.return_message_type_support(introspected);
+    EXPECT_EQ(
+      generated, type_registry.get_message_type_support(&introspection_ts, &type_supports));
+    type_registry.return_message_type_support(generated);
+
+    type_registry.return_message_type_support(generated);
+    type_registry.return_message_type_support(introspected);
+  }
+}
+
+TEST_F(GeneratedTypeSupportTest, generated_and_introspected_are_interchangeable) {
+  TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
+  BaseTypeSupport * generated =
+    type_registry.get_message_type_support(&introspection_ts, &type_supports);
+  BaseTypeSupport * introspected = type_registry.get_message_type_support(&introspection_ts);
+  ASSERT_NE(nullptr, generated);
+  ASSERT_NE(nullptr, introspected);
+
+  Sample sample;
+  sample.flag = 0xA5;
+  sample.id = -42;
+  sample.name = "generated";
+  sample.values = {1.0, -2.5, 3.25};
+
+  std::vector<char> generated_data = serialize(generated, sample);
+  std::vector<char> introspected_data = serialize(introspected, sample);
+  EXPECT_EQ(generated_data, introspected_data);
+
+  expect_equal(sample, deserialize(introspected, generated_data));
+  expect_equal(sample, deserialize(generated, introspected_data));
+
+  type_registry.return_message_type_support(generated);
+  type_registry.return_message_type_support(introspected);
+}
+
+TEST_F(GeneratedTypeSupportTest, thread_type_support_follows_its_handle) {
+  TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
+
+  // Serialized only, no publisher or subscription ever registers the type
+  auto sample_ts = type_registry.get_thread_message_type_support(&introspection_ts);
+  ASSERT_NE(nullptr, sample_ts);
+  EXPECT_EQ(sample_ts, type_registry.get_thread_message_type_support(&introspection_ts));
+
+  // As if the library of the handle was unloaded, and its address reused for another type
+  std::vector<MessageMember> other_array{
+    make_member("id", rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32, 0),
+  };
+  MessageMembers other_members = make_members("Other", sizeof(int32_t), other_array);
+  introspection_ts.data = &other_members;
+  auto other_ts = type_registry.get_thread_message_type_support(&introspection_ts);
+  ASSERT_NE(nullptr, other_ts);
+  EXPECT_NE(sample_ts, other_ts);
+  EXPECT_STRNE(sample_ts->getName(), other_ts->getName());
+
+  // The cache no longer keeps the type support of the former type
+  EXPECT_EQ(1, sample_ts.use_count());
+}
@@ -0,0 +1,82 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TEST_HELPERS_HPP_
+#define TEST_HELPERS_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+
+/// Describe a member of a hand written C++ message, for tests and benchmarks.
+/**
+ * \param array_size number of elements of an array member, 0 if it is not an array.
+ * \param members type support of a message member.
+ */
+inline rosidl_typesupport_introspection_cpp::MessageMember make_member(
+  const char * name, uint8_t type_id, size_t offset, size_t array_size = 0,
+  const rosidl_message_type_support_t * members = nullptr)
+{
+  rosidl_typesupport_introspection_cpp::MessageMember member{};
+  member.name_ = name;
+  member.type_id_ = type_id;
+  member.offset_ = static_cast<uint32_t>(offset);
+  member.is_array_ = array_size != 0;
+  member.array_size_ = array_size;
+  member.members_ = members;
+  return member;
+}
+
+/// Describe a hand written C++ message, members must outlive the result.
+inline rosidl_typesupport_introspection_cpp::MessageMembers make_members(
+  const char * name, size_t size_of,
+  const std::vector<rosidl_typesupport_introspection_cpp::MessageMember> & members)
+{
+  rosidl_typesupport_introspection_cpp::MessageMembers message_members{};
+  message_members.message_namespace_ = "test_msgs::msg";
+  message_members.message_name_ = name;
+  message_members.member_count_ = static_cast<uint32_t>(members.size());
+  message_members.size_of_ = size_of;
+  message_members.members_ = members.data();
+  return message_members;
+}
+
+/// Run fun the given number of times and return the best time in nanoseconds.
+template<typename Function>
+double best_ns(size_t iterations, Function fun)
+{
+  double best = 0.0;
+  for (size_t i = 0; i < iterations; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    fun();
+    double elapsed = std::chrono::duration<double, std::nano>(
+      std::chrono::steady_clock::now() - start).count();
+    best = i == 0 ? elapsed : std::min(best, elapsed);
+  }
+  return best;
+}
+
+/// Run fun the given number of times and return the best time in milliseconds.
+template<typename Function>
+double best_ms(size_t iterations, Function fun)
+{
+  return best_ns(iterations, fun) / 1e6;
+}
+
+#endif  // TEST_HELPERS_HPP_
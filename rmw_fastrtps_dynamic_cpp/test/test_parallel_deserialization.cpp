@@ -0,0 +1,282 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+
+#include "rmw_fastrtps_dynamic_cpp/MessageTypeSupport.hpp"
+#include "rmw_fastrtps_dynamic_cpp/worker_pool.hpp"
+
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+#include "rosidl_typesupport_introspection_cpp/identifier.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+
+#include "test_helpers.hpp"
+
+using eprosima::fastcdr::Cdr;
+using eprosima::fastcdr::FastBuffer;
+using rosidl_typesupport_introspection_cpp::MessageMember;
+using rosidl_typesupport_introspection_cpp::MessageMembers;
+
+using TypeSupport_cpp = rmw_fastrtps_dynamic_cpp::MessageTypeSupport<MessageMembers>;
+
+// Serialized in 48 bytes from an 8 bytes boundary, a multiple of its alignment, so that every
+// element of an array starts on such a boundary
+struct Marker
+{
+  uint8_t action;
+  double x;
+  double y;
+  float color[4];
+  uint32_t id;
+  uint32_t flags;
+};
+
+// Serialized in 9 bytes, so consecutive elements do not share the same alignment
+struct Sample
+{
+  double value;
+  uint8_t quality;
+};
+
+template<typename T>
+struct MarkerArray
+{
+  uint32_t stamp;
+  std::vector<T> markers;
+};
+
+// Serialized in 3 bytes, so an array of an odd number of them ends on an odd offset
+struct Color
+{
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+};
+
+struct Palette
+{
+  std::vector<Color> colors;
+  uint32_t checksum;
+};
+
+template<typename T>
+static size_t size_function(const void * untyped_member)
+{
+  return static_cast<const std::vector<T> *>(untyped_member)->size();
+}
+
+template<typename T>
+static const void * get_const_function(const void * untyped_member, size_t index)
+{
+  return &(*static_cast<const std::vector<T> *>(untyped_member))[index];
+}
+
+template<typename T>
+static void * get_function(void * untyped_member, size_t index)
+{
+  return &(*static_cast<std::vector<T> *>(untyped_member))[index];
+}
+
+template<typename T>
+static void resize_function(void * untyped_member, size_t size)
+{
+  static_cast<std::vector<T> *>(untyped_member)->resize(size);
+}
+
+template<typename T>
+static MessageMember make_sequence_member(
+  const char * name, size_t offset, const rosidl_message_type_support_t * members)
+{
+  MessageMember member = make_member(
+    name, rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE, offset, 0, members);
+  member.is_array_ = true;
+  member.size_function = size_function<T>;
+  member.get_const_function = get_const_function<T>;
+  member.get_function = get_function<T>;
+  member.resize_function = resize_function<T>;
+  return member;
+}
+
+class ParallelDeserializationTest : public ::testing::Test
+{
+public:
+  void TearDown() override
+  {
+    rmw_fastrtps_dynamic_cpp::set_parallel_deserialization_min_size(0);
+  }
+
+  /// Serialize a message and deserialize it back, with arrays deserialized in parallel if possible.
+  template<typename MessageT>
+  void round_trip(
+    const MessageMembers & members, const MessageT & message, MessageT & result,
+    bool expect_parallel)
+  {
+    TypeSupport_cpp type_support(&members, nullptr);
+    std::vector<char> buffer(type_support.getEstimatedSerializedSize(&message, nullptr));
+    FastBuffer fast_buffer(buffer.data(), buffer.size());
+    Cdr ser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+    ASSERT_TRUE(type_support.serializeROSmessage(&message, ser, nullptr));
+
+    rmw_fastrtps_dynamic_cpp::set_parallel_deserialization_min_size(1);
+    auto & pool = rmw_fastrtps_dynamic_cpp::WorkerPool::get_instance();
+    const size_t job_count = pool.job_count();
+    Cdr deser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+    ASSERT_TRUE(type_support.deserializeROSmessage(deser, &result, nullptr));
+    EXPECT_EQ(ser.getSerializedDataLength(), deser.getSerializedDataLength());
+    EXPECT_EQ(expect_parallel, pool.job_count() != job_count);
+  }
+
+  const uint8_t UINT8 = rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8;
+  const uint8_t UINT32 = rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32;
+  const uint8_t FLOAT = rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32;
+  const uint8_t DOUBLE = rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64;
+
+  std::vector<MessageMember> marker_member_array{
+    make_member("action", UINT8, offsetof(Marker, action)),
+    make_member("x", DOUBLE, offsetof(Marker, x)),
+    make_member("y", DOUBLE, offsetof(Marker, y)),
+    make_member("color", FLOAT, offsetof(Marker, color), 4),
+    make_member("id", UINT32, offsetof(Marker, id)),
+    make_member("flags", UINT32, offsetof(Marker, flags)),
+  };
+  MessageMembers marker_members = make_members("Marker", sizeof(Marker), marker_member_array);
+  rosidl_message_type_support_t marker_ts{
+    rosidl_typesupport_introspection_cpp::typesupport_identifier, &marker_members, nullptr};
+
+  std::vector<MessageMember> marker_array_member_array{
+    make_member("stamp", UINT32, offsetof(MarkerArray<Marker>, stamp)),
+    make_sequence_member<Marker>(
+      "markers", offsetof(MarkerArray<Marker>, markers), &marker_ts),
+  };
+  MessageMembers marker_array_members =
+    make_members("MarkerArray", sizeof(MarkerArray<Marker>), marker_array_member_array);
+
+  std::vector<MessageMember> sample_member_array{
+    make_member("value", DOUBLE, offsetof(Sample, value)),
+    make_member("quality", UINT8, offsetof(Sample, quality)),
+  };
+  MessageMembers sample_members = make_members("Sample", sizeof(Sample), sample_member_array);
+  rosidl_message_type_support_t sample_ts{
+    rosidl_typesupport_introspection_cpp::typesupport_identifier, &sample_members, nullptr};
+
+  std::vector<MessageMember> sample_array_member_array{
+    make_member("stamp", UINT32, offsetof(MarkerArray<Sample>, stamp)),
+    make_sequence_member<Sample>(
+      "markers", offsetof(MarkerArray<Sample>, markers), &sample_ts),
+  };
+  MessageMembers sample_array_members =
+    make_members("SampleArray", sizeof(MarkerArray<Sample>), sample_array_member_array);
+
+  std::vector<MessageMember> color_member_array{
+    make_member("r", UINT8, offsetof(Color, r)),
+    make_member("g", UINT8, offsetof(Color, g)),
+    make_member("b", UINT8, offsetof(Color, b)),
+  };
+  MessageMembers color_members = make_members("Color", sizeof(Color), color_member_array);
+  rosidl_message_type_support_t color_ts{
+    rosidl_typesupport_introspection_cpp::typesupport_identifier, &color_members, nullptr};
+
+  std::vector<MessageMember> palette_member_array{
+    make_sequence_member<Color>("colors", offsetof(Palette, colors), &color_ts),
+    make_member("checksum", UINT32, offsetof(Palette, checksum)),
+  };
+  MessageMembers palette_members =
+    make_members("Palette", sizeof(Palette), palette_member_array);
+};
+
+TEST_F(ParallelDeserializationTest, fixed_size_elements) {
+  MarkerArray<Marker> message;
+  message.stamp = 42;
+  message.markers.resize(1000);
+  for (size_t i = 0; i < message.markers.size(); ++i) {
+    Marker & marker = message.markers[i];
+    marker.action = static_cast<uint8_t>(i % 3);
+    marker.x = 0.5 * i;
+    marker.y = -0.25 * i;
+    for (size_t j = 0; j < 4; ++j) {
+      marker.color[j] = static_cast<float>(i + j);
+    }
+    marker.id = static_cast<uint32_t>(i);
+    marker.flags = static_cast<uint32_t>(i * 7);
+  }
+
+  MarkerArray<Marker> result;
+  // Existing elements are overwritten in place
+  result.markers.resize(10);
+  round_trip(marker_array_members, message, result, true);
+
+  EXPECT_EQ(message.stamp, result.stamp);
+  ASSERT_EQ(message.markers.size(), result.markers.size());
+  for (size_t i = 0; i < message.markers.size(); ++i) {
+    const Marker & expected = message.markers[i];
+    const Marker & marker = result.markers[i];
+    EXPECT_EQ(expected.action, marker.action);
+    EXPECT_EQ(expected.x, marker.x);
+    EXPECT_EQ(expected.y, marker.y);
+    EXPECT_EQ(0, memcmp(expected.color, marker.color, sizeof(marker.color)));
+    EXPECT_EQ(expected.id, marker.id);
+    EXPECT_EQ(expected.flags, marker.flags);
+  }
+}
+
+TEST_F(ParallelDeserializationTest, elements_of_varying_alignment) {
+  MarkerArray<Sample> message;
+  message.stamp = 7;
+  message.markers.resize(333);
+  for (size_t i = 0; i < message.markers.size(); ++i) {
+    message.markers[i].value = 1.5 * i;
+    message.markers[i].quality = static_cast<uint8_t>(i);
+  }
+
+  MarkerArray<Sample> result;
+  // Deserialized on the calling thread, as the offset of each element is not known up front
+  round_trip(sample_array_members, message, result, false);
+
+  EXPECT_EQ(message.stamp, result.stamp);
+  ASSERT_EQ(message.markers.size(), result.markers.size());
+  for (size_t i = 0; i < message.markers.size(); ++i) {
+    EXPECT_EQ(message.markers[i].value, result.markers[i].value);
+    EXPECT_EQ(message.markers[i].quality, result.markers[i].quality);
+  }
+}
+
+TEST_F(ParallelDeserializationTest, field_after_an_odd_sized_array_is_aligned) {
+  Palette message;
+  message.colors.resize(1001);
+  for (size_t i = 0; i < message.colors.size(); ++i) {
+    message.colors[i].r = static_cast<uint8_t>(i);
+    message.colors[i].g = static_cast<uint8_t>(i >> 8);
+    message.colors[i].b = static_cast<uint8_t>(i * 3);
+  }
+  message.checksum = 0x12345678;
+
+  Palette result;
+  round_trip(palette_members, message, result, true);
+
+  ASSERT_EQ(message.colors.size(), result.colors.size());
+  for (size_t i = 0; i < message.colors.size(); ++i) {
+    EXPECT_EQ(message.colors[i].r, result.colors[i].r);
+    EXPECT_EQ(message.colors[i].g, result.colors[i].g);
+    EXPECT_EQ(message.colors[i].b, result.colors[i].b);
+  }
+  // Past the byte of padding which follows the 4 + 3003 bytes of the array
+  EXPECT_EQ(message.checksum, result.checksum);
+}
@@ -0,0 +1,221 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+
+#include "rmw_fastrtps_dynamic_cpp/MessageTypeSupport.hpp"
+
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+#include "rosidl_typesupport_introspection_cpp/identifier.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+
+#include "test_helpers.hpp"
+
+using eprosima::fastcdr::Cdr;
+using eprosima::fastcdr::FastBuffer;
+using rosidl_typesupport_introspection_cpp::MessageMember;
+using rosidl_typesupport_introspection_cpp::MessageMembers;
+
+using TypeSupport_cpp = rmw_fastrtps_dynamic_cpp::MessageTypeSupport<MessageMembers>;
+
+struct Vector3
+{
+  double x;
+  double y;
+  double z;
+};
+
+struct Twist
+{
+  Vector3 linear;
+  Vector3 angular;
+};
+
+// Padding between members, which CDR adds at the same places
+struct Mixed
+{
+  uint8_t flag;
+  double value;
+  int16_t data[3];
+  uint32_t count;
+};
+
+struct Inner
+{
+  double d;
+  uint8_t c;
+};
+
+// The trailing padding of Inner is not in CDR, so e is not where CDR puts it
+struct Outer
+{
+  Inner inner;
+  uint8_t e;
+};
+
+class PlainTypeSupportTest : public ::testing::Test
+{
+public:
+  const uint8_t UINT8 = rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8;
+  const uint8_t INT16 = rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16;
+  const uint8_t UINT32 = rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32;
+  const uint8_t DOUBLE = rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64;
+  const uint8_t MESSAGE = rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE;
+
+  std::vector<MessageMember> vector3_member_array{
+    make_member("x", DOUBLE, offsetof(Vector3, x)),
+    make_member("y", DOUBLE, offsetof(Vector3, y)),
+    make_member("z", DOUBLE, offsetof(Vector3, z)),
+  };
+  MessageMembers vector3_members = make_members("Vector3", sizeof(Vector3), vector3_member_array);
+  rosidl_message_type_support_t vector3_ts{
+    rosidl_typesupport_introspection_cpp::typesupport_identifier, &vector3_members, nullptr};
+
+  std::vector<MessageMember> twist_member_array{
+    make_member("linear", MESSAGE, offsetof(Twist, linear), 0, &vector3_ts),
+    make_member("angular", MESSAGE, offsetof(Twist, angular), 0, &vector3_ts),
+  };
+  MessageMembers twist_members = make_members("Twist", sizeof(Twist), twist_member_array);
+
+  std::vector<MessageMember> mixed_member_array{
+    make_member("flag", UINT8, offsetof(Mixed, flag)),
+    make_member("value", DOUBLE, offsetof(Mixed, value)),
+    make_member("data", INT16, offsetof(Mixed, data), 3),
+    make_member("count", UINT32, offsetof(Mixed, count)),
+  };
+  MessageMembers mixed_members = make_members("Mixed", sizeof(Mixed), mixed_member_array);
+
+  std::vector<MessageMember> inner_member_array{
+    make_member("d", DOUBLE, offsetof(Inner, d)),
+    make_member("c", UINT8, offsetof(Inner, c)),
+  };
+  MessageMembers inner_members = make_members("Inner", sizeof(Inner), inner_member_array);
+  rosidl_message_type_support_t inner_ts{
+    rosidl_typesupport_introspection_cpp::typesupport_identifier, &inner_members, nullptr};
+
+  std::vector<MessageMember> outer_member_array{
+    make_member("inner", MESSAGE, offsetof(Outer, inner), 0, &inner_ts),
+    make_member("e", UINT8, offsetof(Outer, e)),
+  };
+  MessageMembers outer_members = make_members("Outer", sizeof(Outer), outer_member_array);
+};
+
+/// Serialize a message with the type support and field by field, and compare the bytes.
+static void expect_same_serialization(
+  const TypeSupport_cpp & type_support, const void * ros_message,
+  std::function<void(Cdr &)> serialize_fields, Cdr::Endianness endianness)
+{
+  char buffer[256] = {};
+  char expected_buffer[256] = {};
+
+  FastBuffer fast_buffer(buffer, sizeof(buffer));
+  Cdr ser(fast_buffer, endianness, Cdr::DDS_CDR);
+  ASSERT_TRUE(type_support.serializeROSmessage(ros_message, ser, nullptr));
+
+  FastBuffer expected_fast_buffer(expected_buffer, sizeof(expected_buffer));
+  Cdr expected_ser(expected_fast_buffer, endianness, Cdr::DDS_CDR);
+  expected_ser.serialize_encapsulation();
+  serialize_fields(expected_ser);
+
+  ASSERT_EQ(expected_ser.getSerializedDataLength(), ser.getSerializedDataLength());
+  EXPECT_EQ(0, memcmp(expected_buffer, buffer, ser.getSerializedDataLength()));
+  EXPECT_EQ(type_support.m_typeSize, ser.getSerializedDataLength());
+}
+
+TEST_F(PlainTypeSupportTest, detects_plain_layouts) {
+  EXPECT_TRUE(TypeSupport_cpp(&vector3_members, nullptr).is_plain());
+  EXPECT_TRUE(TypeSupport_cpp(&twist_members, nullptr).is_plain());
+  EXPECT_TRUE(TypeSupport_cpp(&mixed_members, nullptr).is_plain());
+  EXPECT_TRUE(TypeSupport_cpp(&inner_members, nullptr).is_plain());
+  EXPECT_FALSE(TypeSupport_cpp(&outer_members, nullptr).is_plain());
+}
+
+TEST_F(PlainTypeSupportTest, plain_serialization_matches_field_by_field) {
+  TypeSupport_cpp twist_type_support(&twist_members, nullptr);
+  TypeSupport_cpp mixed_type_support(&mixed_members, nullptr);
+  TypeSupport_cpp outer_type_support(&outer_members, nullptr);
+
+  Twist twist{{1.0, 2.0, 3.0}, {-4.0, -5.0, -6.0}};
+  Mixed mixed;
+  // Zero the padding, CDR does not write it either
+  memset(&mixed, 0, sizeof(mixed));
+  mixed.flag = 0xA5;
+  mixed.value = 3.14159;
+  mixed.data[0] = -1;
+  mixed.data[1] = 2;
+  mixed.data[2] = 0x1234;
+  mixed.count = 0xDEADBEEF;
+  Outer outer;
+  memset(&outer, 0, sizeof(outer));
+  outer.inner.d = 42.0;
+  outer.inner.c = 7;
+  outer.e = 9;
+
+  for (auto endianness : {Cdr::LITTLE_ENDIANNESS, Cdr::BIG_ENDIANNESS}) {
+    expect_same_serialization(
+      twist_type_support, &twist, [&twist](Cdr & ser) {
+        ser << twist.linear.x << twist.linear.y << twist.linear.z;
+        ser << twist.angular.x << twist.angular.y << twist.angular.z;
+      }, endianness);
+    expect_same_serialization(
+      mixed_type_support, &mixed, [&mixed](Cdr & ser) {
+        ser << mixed.flag << mixed.value;
+        ser.serializeArray(mixed.data, 3);
+        ser << mixed.count;
+      }, endianness);
+    expect_same_serialization(
+      outer_type_support, &outer, [&outer](Cdr & ser) {
+        ser << outer.inner.d << outer.inner.c << outer.e;
+      }, endianness);
+  }
+}
+
+TEST_F(PlainTypeSupportTest, plain_deserialization_round_trip) {
+  TypeSupport_cpp mixed_type_support(&mixed_members, nullptr);
+
+  Mixed mixed;
+  memset(&mixed, 0, sizeof(mixed));
+  mixed.flag = 1;
+  mixed.value = -0.5;
+  mixed.data[0] = 10;
+  mixed.data[1] = 20;
+  mixed.data[2] = 30;
+  mixed.count = 40;
+
+  for (auto endianness : {Cdr::LITTLE_ENDIANNESS, Cdr::BIG_ENDIANNESS}) {
+    char buffer[256] = {};
+    FastBuffer fast_buffer(buffer, sizeof(buffer));
+    Cdr ser(fast_buffer, endianness, Cdr::DDS_CDR);
+    ASSERT_TRUE(mixed_type_support.serializeROSmessage(&mixed, ser, nullptr));
+
+    Mixed result;
+    memset(&result, 0, sizeof(result));
+    Cdr deser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+    ASSERT_TRUE(mixed_type_support.deserializeROSmessage(deser, &result, nullptr));
+    EXPECT_EQ(mixed.flag, result.flag);
+    EXPECT_EQ(mixed.value, result.value);
+    EXPECT_EQ(mixed.data[0], result.data[0]);
+    EXPECT_EQ(mixed.data[1], result.data[1]);
+    EXPECT_EQ(mixed.data[2], result.data[2]);
+    EXPECT_EQ(mixed.count, result.count);
+  }
+}
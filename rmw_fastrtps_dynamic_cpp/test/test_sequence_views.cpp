@@ -0,0 +1,225 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+
+#include "rmw_fastrtps_dynamic_cpp/MessageTypeSupport.hpp"
+
+#include "rosidl_generator_c/primitives_sequence.h"
+#include "rosidl_generator_c/primitives_sequence_functions.h"
+
+#include "rosidl_typesupport_introspection_c/message_introspection.h"
+
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+
+using eprosima::fastcdr::Cdr;
+using eprosima::fastcdr::FastBuffer;
+
+using TypeSupport_c = rmw_fastrtps_dynamic_cpp::MessageTypeSupport<
+  rosidl_typesupport_introspection_c__MessageMembers>;
+
+struct Grid
+{
+  uint32_t width;
+  rosidl_generator_c__uint8__Sequence data;
+  rosidl_generator_c__float32__Sequence ranges;
+  rosidl_generator_c__float64__Sequence weights;
+};
+
+static rosidl_typesupport_introspection_c__MessageMember make_sequence_member(
+  const char * name, uint8_t type_id, size_t offset)
+{
+  rosidl_typesupport_introspection_c__MessageMember member{};
+  member.name_ = name;
+  member.type_id_ = type_id;
+  member.offset_ = static_cast<uint32_t>(offset);
+  member.is_array_ = true;
+  return member;
+}
+
+class SequenceViewsTest : public ::testing::Test
+{
+public:
+  void SetUp() override
+  {
+    rosidl_typesupport_introspection_c__MessageMember width{};
+    width.name_ = "width";
+    width.type_id_ = rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32;
+    width.offset_ = offsetof(Grid, width);
+    member_array = {
+      width,
+      make_sequence_member(
+        "data", rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8, offsetof(Grid, data)),
+      make_sequence_member(
+        "ranges", rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32, offsetof(Grid, ranges)),
+      make_sequence_member(
+        "weights", rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64, offsetof(Grid, weights)),
+    };
+    members.message_namespace_ = "test_msgs__msg";
+    members.message_name_ = "Grid";
+    members.member_count_ = static_cast<uint32_t>(member_array.size());
+    members.size_of_ = sizeof(Grid);
+    members.members_ = member_array.data();
+
+    memset(&grid, 0, sizeof(grid));
+    grid.width = 64;
+    ASSERT_TRUE(rosidl_generator_c__uint8__Sequence__init(&grid.data, 4096));
+    for (size_t i = 0; i < grid.data.size; ++i) {
+      grid.data.data[i] = static_cast<uint8_t>(i);
+    }
+    ASSERT_TRUE(rosidl_generator_c__float32__Sequence__init(&grid.ranges, 1024));
+    for (size_t i = 0; i < grid.ranges.size; ++i) {
+      grid.ranges.data[i] = 0.5f * i;
+    }
+    ASSERT_TRUE(rosidl_generator_c__float64__Sequence__init(&grid.weights, 1024));
+    for (size_t i = 0; i < grid.weights.size; ++i) {
+      grid.weights.data[i] = 0.25 * i;
+    }
+  }
+
+  void TearDown() override
+  {
+    rosidl_generator_c__uint8__Sequence__fini(&grid.data);
+    rosidl_generator_c__float32__Sequence__fini(&grid.ranges);
+    rosidl_generator_c__float64__Sequence__fini(&grid.weights);
+  }
+
+  std::vector<rosidl_typesupport_introspection_c__MessageMember> member_array;
+  rosidl_typesupport_introspection_c__MessageMembers members{};
+  Grid grid;
+  alignas(8) char buffer[32768];
+};
+
+static bool points_into(const void * pointer, const char * buffer, size_t size)
+{
+  auto byte = static_cast<const char *>(pointer);
+  return byte >= buffer && byte < buffer + size;
+}
+
+TEST_F(SequenceViewsTest, large_aligned_sequences_point_into_the_buffer) {
+  TypeSupport_c type_support(&members, nullptr);
+  FastBuffer fast_buffer(buffer, sizeof(buffer));
+  Cdr ser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+  ASSERT_TRUE(type_support.serializeROSmessage(&grid, ser, nullptr));
+
+  rmw_fastrtps_dynamic_cpp::SequenceViews views{buffer + 4, 1024, {}};
+  Grid result;
+  memset(&result, 0, sizeof(result));
+  Cdr deser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+  rmw_fastrtps_dynamic_cpp::current_sequence_views() = &views;
+  ASSERT_TRUE(type_support.deserializeROSmessage(deser, &result, nullptr));
+  rmw_fastrtps_dynamic_cpp::current_sequence_views() = nullptr;
+
+  EXPECT_EQ(64u, result.width);
+  // The float64 elements are 4 bytes away from an 8 bytes boundary in this buffer
+  ASSERT_EQ(2u, views.sequences.size());
+  EXPECT_EQ(&result.data, views.sequences[0]);
+  EXPECT_EQ(&result.ranges, views.sequences[1]);
+  EXPECT_TRUE(points_into(result.data.data, buffer, sizeof(buffer)));
+  EXPECT_TRUE(points_into(result.ranges.data, buffer, sizeof(buffer)));
+  EXPECT_FALSE(points_into(result.weights.data, buffer, sizeof(buffer)));
+
+  ASSERT_EQ(grid.data.size, result.data.size);
+  EXPECT_EQ(0, memcmp(grid.data.data, result.data.data, grid.data.size));
+  ASSERT_EQ(grid.ranges.size, result.ranges.size);
+  EXPECT_EQ(0, memcmp(grid.ranges.data, result.ranges.data, grid.ranges.size * sizeof(float)));
+  ASSERT_EQ(grid.weights.size, result.weights.size);
+  EXPECT_EQ(
+    0, memcmp(grid.weights.data, result.weights.data, grid.weights.size * sizeof(double)));
+
+  rosidl_generator_c__float64__Sequence__fini(&result.weights);
+}
+
+TEST_F(SequenceViewsTest, small_sequences_are_copied) {
+  TypeSupport_c type_support(&members, nullptr);
+  FastBuffer fast_buffer(buffer, sizeof(buffer));
+  Cdr ser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+  ASSERT_TRUE(type_support.serializeROSmessage(&grid, ser, nullptr));
+
+  // Only the 4096 bytes of data reach the threshold
+  rmw_fastrtps_dynamic_cpp::SequenceViews views{buffer + 4, 4096, {}};
+  Grid result;
+  memset(&result, 0, sizeof(result));
+  Cdr deser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+  rmw_fastrtps_dynamic_cpp::current_sequence_views() = &views;
+  ASSERT_TRUE(type_support.deserializeROSmessage(deser, &result, nullptr));
+  rmw_fastrtps_dynamic_cpp::current_sequence_views() = nullptr;
+
+  ASSERT_EQ(1u, views.sequences.size());
+  EXPECT_TRUE(points_into(result.data.data, buffer, sizeof(buffer)));
+  EXPECT_FALSE(points_into(result.ranges.data, buffer, sizeof(buffer)));
+  EXPECT_EQ(0, memcmp(grid.ranges.data, result.ranges.data, grid.ranges.size * sizeof(float)));
+
+  rosidl_generator_c__float32__Sequence__fini(&result.ranges);
+  rosidl_generator_c__float64__Sequence__fini(&result.weights);
+}
+
+struct Packet
+{
+  rosidl_generator_c__uint8__Sequence bytes;
+  uint32_t checksum;
+};
+
+TEST_F(SequenceViewsTest, field_after_an_odd_length_sequence_is_aligned) {
+  rosidl_typesupport_introspection_c__MessageMember checksum{};
+  checksum.name_ = "checksum";
+  checksum.type_id_ = rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32;
+  checksum.offset_ = offsetof(Packet, checksum);
+  std::vector<rosidl_typesupport_introspection_c__MessageMember> packet_member_array{
+    make_sequence_member(
+      "bytes", rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8, offsetof(Packet, bytes)),
+    checksum,
+  };
+  rosidl_typesupport_introspection_c__MessageMembers packet_members{};
+  packet_members.message_namespace_ = "test_msgs__msg";
+  packet_members.message_name_ = "Packet";
+  packet_members.member_count_ = static_cast<uint32_t>(packet_member_array.size());
+  packet_members.size_of_ = sizeof(Packet);
+  packet_members.members_ = packet_member_array.data();
+
+  Packet packet;
+  ASSERT_TRUE(rosidl_generator_c__uint8__Sequence__init(&packet.bytes, 1023));
+  memset(packet.bytes.data, 0x5a, packet.bytes.size);
+  packet.checksum = 0x12345678;
+
+  TypeSupport_c type_support(&packet_members, nullptr);
+  FastBuffer fast_buffer(buffer, sizeof(buffer));
+  Cdr ser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+  ASSERT_TRUE(type_support.serializeROSmessage(&packet, ser, nullptr));
+
+  rmw_fastrtps_dynamic_cpp::SequenceViews views{buffer + 4, 1, {}};
+  Packet result;
+  memset(&result, 0, sizeof(result));
+  Cdr deser(fast_buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+  rmw_fastrtps_dynamic_cpp::current_sequence_views() = &views;
+  ASSERT_TRUE(type_support.deserializeROSmessage(deser, &result, nullptr));
+  rmw_fastrtps_dynamic_cpp::current_sequence_views() = nullptr;
+
+  ASSERT_EQ(1u, views.sequences.size());
+  EXPECT_TRUE(points_into(result.bytes.data, buffer, sizeof(buffer)));
+  ASSERT_EQ(packet.bytes.size, result.bytes.size);
+  EXPECT_EQ(0, memcmp(packet.bytes.data, result.bytes.data, packet.bytes.size));
+  // Past the byte of padding which follows the 4 + 1023 bytes of the sequence
+  EXPECT_EQ(packet.checksum, result.checksum);
+  EXPECT_EQ(ser.getSerializedDataLength(), deser.getSerializedDataLength());
+
+  rosidl_generator_c__uint8__Sequence__fini(&packet.bytes);
+}
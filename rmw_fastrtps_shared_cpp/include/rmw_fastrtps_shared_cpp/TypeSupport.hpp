@@ -25,6 +25,9 @@
 
 #include "rcutils/logging_macros.h"
 
+#include "rmw/types.h"
+
+#include "./payload_sizing.hpp"
 #include "./visibility_control.h"
 
 namespace rmw_fastrtps_shared_cpp
@@ -36,6 +39,14 @@ struct SerializedData
   bool is_cdr_buffer;  // Whether next field is a pointer to a Cdr or to a plain ros message
   void * data;
   const void * impl;   // RMW implementation specific data
+  // On take, when set, the received payload buffer is swapped into it instead of being
+  // deserialized, so the sample is kept without being copied (is_cdr_buffer is ignored)
+  eprosima::fastrtps::rtps::SerializedPayload_t * retained_payload = nullptr;
+  // When set, the serialized message is copied straight to or from the payload, without
+  // going through a Cdr or a FastBuffer (is_cdr_buffer is ignored)
+  rmw_serialized_message_t * serialized_message = nullptr;
+  // On publish, when set, the payload is reserved and accounted for by it
+  PayloadSizing * payload_sizing = nullptr;
 };
 
 class TypeSupport : public eprosima::fastrtps::TopicDataType
@@ -77,10 +88,31 @@ public:
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   virtual ~TypeSupport() {}
 
+  /// Whether every message of this type fits in m_typeSize bytes once serialized.
+  bool is_bounded() const
+  {
+    return max_size_bound_;
+  }
+
 protected:
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   TypeSupport();
 
+  /// serialize(), with ROS messages serialized by type instead of this type support.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  static bool serialize(
+    const TypeSupport * type, void * data, eprosima::fastrtps::rtps::SerializedPayload_t * payload);
+
+  /// deserialize(), with ROS messages deserialized by type instead of this type support.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  static bool deserialize(
+    const TypeSupport * type, eprosima::fastrtps::rtps::SerializedPayload_t * payload, void * data);
+
+  /// getSerializedSizeProvider(), with ROS messages measured by type instead of this type support.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  static std::function<uint32_t()> getSerializedSizeProvider(
+    const TypeSupport * type, void * data);
+
   bool max_size_bound_;
 };
 
@@ -0,0 +1,69 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__BYTE_SWAP_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__BYTE_SWAP_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Reverse the bytes of every element of an array in place.
+/**
+ * Uses AVX2 or SSE2 on x86 and NEON on ARM when available, plain loops otherwise.
+ *
+ * \param data array to swap, it does not need to be aligned.
+ * \param count number of elements in the array.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+byte_swap_16(uint16_t * data, size_t count);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+byte_swap_32(uint32_t * data, size_t count);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+byte_swap_64(uint64_t * data, size_t count);
+
+/// Reverse the bytes of every element of an array of arithmetic values in place.
+template<typename T>
+void
+byte_swap(T * data, size_t count)
+{
+  static_assert(std::is_arithmetic<T>::value, "only arithmetic types can be byte swapped");
+  switch (sizeof(T)) {
+    case 2:
+      byte_swap_16(reinterpret_cast<uint16_t *>(data), count);
+      break;
+    case 4:
+      byte_swap_32(reinterpret_cast<uint32_t *>(data), count);
+      break;
+    case 8:
+      byte_swap_64(reinterpret_cast<uint64_t *>(data), count);
+      break;
+    default:
+      break;
+  }
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__BYTE_SWAP_HPP_
@@ -15,9 +15,19 @@
 #ifndef RMW_FASTRTPS_SHARED_CPP__CUSTOM_PARTICIPANT_INFO_HPP_
 #define RMW_FASTRTPS_SHARED_CPP__CUSTOM_PARTICIPANT_INFO_HPP_
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <set>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "fastrtps/attributes/ParticipantAttributes.h"
@@ -31,17 +41,116 @@
 #include "rmw/rmw.h"
 
 #include "rmw_common.hpp"
+#include "rmw_context_impl.hpp"
 
 #include "topic_cache.hpp"
 
 class ParticipantListener;
 
+namespace rmw_fastrtps_shared_cpp
+{
+
+// Key of the participant user data which marks a participant shared by several
+// nodes; the nodes of such participants are announced through their endpoints.
+constexpr char kSharedParticipantUserDataKey[] = "shared";
+
+// Entity kind used for node GUIDs, from the vendor specific range so it can never
+// clash with the entity ids of the endpoints of the same participant.
+constexpr eprosima::fastrtps::rtps::octet kNodeEntityKind = 0xC1;
+
+/**
+ * Build the GUID identifying a node which lives on a shared participant.
+ *
+ * \param prefix the GUID prefix of the participant
+ * \param node_id the id of the node, unique within the participant
+ * \return the node GUID
+ */
+inline GUID_t
+create_node_guid(const eprosima::fastrtps::rtps::GuidPrefix_t & prefix, uint32_t node_id)
+{
+  GUID_t node_guid;
+  node_guid.guidPrefix = prefix;
+  node_guid.entityId.value[0] = static_cast<eprosima::fastrtps::rtps::octet>(node_id >> 16);
+  node_guid.entityId.value[1] = static_cast<eprosima::fastrtps::rtps::octet>(node_id >> 8);
+  node_guid.entityId.value[2] = static_cast<eprosima::fastrtps::rtps::octet>(node_id);
+  node_guid.entityId.value[3] = kNodeEntityKind;
+  return node_guid;
+}
+
+/**
+ * Build the user data attached to every endpoint of a node on a shared participant.
+ *
+ * \param name the name of the node
+ * \param namespace_ the namespace of the node
+ * \param node_id the id of the node, unique within the participant
+ * \return the user data in the same key-value format as the participant user data
+ */
+inline std::vector<eprosima::fastrtps::rtps::octet>
+create_node_user_data(const char * name, const char * namespace_, uint32_t node_id)
+{
+  std::string user_data = std::string("name=") + name + ";namespace=" + namespace_ +
+    ";node=" + std::to_string(node_id) + ";";
+  return std::vector<eprosima::fastrtps::rtps::octet>(user_data.begin(), user_data.end());
+}
+
+/**
+ * Extract the node an endpoint belongs to from the endpoint user data.
+ *
+ * \param endpoint_guid the GUID of the discovered endpoint
+ * \param user_data the user data of the discovered endpoint
+ * \param node_guid [out] the GUID of the node
+ * \param name [out] the name of the node
+ * \param namespace_ [out] the namespace of the node
+ * \return false if the endpoint does not carry node information
+ */
+inline bool
+get_node_from_user_data(
+  const GUID_t & endpoint_guid,
+  const std::vector<eprosima::fastrtps::rtps::octet> & user_data,
+  GUID_t & node_guid,
+  std::string & name,
+  std::string & namespace_)
+{
+  if (user_data.empty()) {
+    return false;
+  }
+  auto map = rmw::impl::cpp::parse_key_value(user_data);
+  auto name_found = map.find("name");
+  auto ns_found = map.find("namespace");
+  auto id_found = map.find("node");
+  if (name_found == map.end() || ns_found == map.end() || id_found == map.end()) {
+    return false;
+  }
+  std::string node_id(id_found->second.begin(), id_found->second.end());
+  char * end = nullptr;
+  unsigned long id = strtoul(node_id.c_str(), &end, 10);  // NOLINT(runtime/int)
+  if (node_id.empty() || *end != '\0') {
+    return false;
+  }
+  name = std::string(name_found->second.begin(), name_found->second.end());
+  namespace_ = std::string(ns_found->second.begin(), ns_found->second.end());
+  node_guid = create_node_guid(endpoint_guid.guidPrefix, static_cast<uint32_t>(id));
+  return true;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
+
 typedef struct CustomParticipantInfo
 {
+  // Participant and listener are owned by the context and shared between its nodes.
   eprosima::fastrtps::Participant * participant;
   ::ParticipantListener * listener;
   rmw_guard_condition_t * graph_guard_condition;
 
+  // Identifies this node in the graph; the participant GUID is shared with other nodes.
+  GUID_t node_guid;
+
+  // User data attached to all the endpoints created by this node.
+  std::vector<eprosima::fastrtps::rtps::octet> endpoint_user_data;
+
+  rmw_context_impl_t * context;
+  SharedParticipantKey participant_key;
+
   // Flag to establish if the QoS of the participant,
   // its publishers and its subscribers are going
   // to be configured only from an XML file or if
@@ -53,9 +162,87 @@ typedef struct CustomParticipantInfo
 class ParticipantListener : public eprosima::fastrtps::ParticipantListener
 {
 public:
-  explicit ParticipantListener(rmw_guard_condition_t * graph_guard_condition)
-  : graph_guard_condition_(graph_guard_condition)
-  {}
+  /**
+   * \param graph_notification_period when not zero, graph changes happening within this
+   *   period are coalesced into a single trigger of the graph guard conditions
+   */
+  explicit ParticipantListener(
+    std::chrono::milliseconds graph_notification_period = std::chrono::milliseconds(0))
+  : graph_notification_period_(graph_notification_period)
+  {
+    if (graph_notification_period_.count() > 0) {
+      notification_thread_ = std::thread(&ParticipantListener::notification_thread, this);
+    }
+  }
+
+  ~ParticipantListener()
+  {
+    if (notification_thread_.joinable()) {
+      {
+        std::lock_guard<std::mutex> guard(notification_mutex_);
+        stop_notification_thread_ = true;
+      }
+      notification_cv_.notify_one();
+      notification_thread_.join();
+    }
+  }
+
+  void attach_graph_guard_condition(rmw_guard_condition_t * graph_guard_condition)
+  {
+    std::lock_guard<std::mutex> guard(graph_guard_conditions_mutex_);
+    graph_guard_conditions_[graph_guard_condition];
+  }
+
+  void detach_graph_guard_condition(rmw_guard_condition_t * graph_guard_condition)
+  {
+    std::lock_guard<std::mutex> guard(graph_guard_conditions_mutex_);
+    graph_guard_conditions_.erase(graph_guard_condition);
+  }
+
+  /**
+   * Register a node created on the participant of this listener.
+   *
+   * Local nodes are known even before any of their endpoints is discovered.
+   */
+  void add_local_node(
+    const GUID_t & node_guid, const std::string & name, const std::string & namespace_)
+  {
+    {
+      std::lock_guard<std::mutex> guard(names_mutex_);
+      add_node_reference(node_guid, name, namespace_);
+    }
+    graph_changed();
+  }
+
+  void remove_local_node(const GUID_t & node_guid)
+  {
+    {
+      std::lock_guard<std::mutex> guard(names_mutex_);
+      remove_node_reference(node_guid);
+    }
+    graph_changed();
+  }
+
+  /**
+   * Get the DDS names of the topics which changed since the last call for this guard condition.
+   *
+   * Changes are only recorded for the guard conditions this was called for, the first call
+   * starts recording them and returns nothing.
+   *
+   * \param graph_guard_condition an attached graph guard condition
+   * \return the topics on which endpoints appeared or went away
+   */
+  std::set<std::string> take_changed_topics(rmw_guard_condition_t * graph_guard_condition)
+  {
+    std::set<std::string> changed_topics;
+    std::lock_guard<std::mutex> guard(graph_guard_conditions_mutex_);
+    auto it = graph_guard_conditions_.find(graph_guard_condition);
+    if (it != graph_guard_conditions_.end()) {
+      it->second.recorded = true;
+      changed_topics.swap(it->second.topics);
+    }
+    return changed_topics;
+  }
 
   void onParticipantDiscovery(
     eprosima::fastrtps::Participant *,
@@ -74,6 +261,10 @@ public:
       // ignore already known GUIDs
       if (discovered_names.find(info.info.m_guid) == discovered_names.end()) {
         auto map = rmw::impl::cpp::parse_key_value(info.info.m_userData);
+        if (map.find(rmw_fastrtps_shared_cpp::kSharedParticipantUserDataKey) != map.end()) {
+          // nodes of shared participants are announced by their endpoints
+          return;
+        }
         auto name_found = map.find("name");
         auto ns_found = map.find("namespace");
 
@@ -93,26 +284,49 @@ public:
         }
         // ignore discovered participants without a name
         if (!name.empty()) {
-          discovered_names[info.info.m_guid] = name;
-          discovered_namespaces[info.info.m_guid] = namespace_;
+          add_discovered_node(info.info.m_guid, name, namespace_);
+          graph_version_.fetch_add(1u);
         }
       }
     } else {
-      {
-        auto it = discovered_names.find(info.info.m_guid);
-        // only consider known GUIDs
-        if (it != discovered_names.end()) {
-          discovered_names.erase(it);
+      // forget the participant and every node which lived on it
+      const auto & prefix = info.info.m_guid.guidPrefix;
+      std::vector<GUID_t> removed_nodes;
+      for (const auto & guid_name_pair : discovered_names) {
+        if (guid_name_pair.first.guidPrefix == prefix) {
+          removed_nodes.push_back(guid_name_pair.first);
         }
       }
-      {
-        auto it = discovered_namespaces.find(info.info.m_guid);
-        // only consider known GUIDs
-        if (it != discovered_namespaces.end()) {
-          discovered_namespaces.erase(it);
-        }
+      for (const auto & node_guid : removed_nodes) {
+        node_references_.erase(node_guid);
+        remove_discovered_node(node_guid);
       }
+      if (!removed_nodes.empty()) {
+        graph_version_.fetch_add(1u);
+      }
+    }
+  }
+
+  /**
+   * Find the GUID of a discovered node.
+   *
+   * If several nodes share the same name and namespace, the one with the lowest GUID is returned.
+   *
+   * \param node_namespace of the desired node
+   * \param node_name of the desired node
+   * \param guid [out] result
+   * \return false if no such node is known
+   */
+  bool get_node_guid(
+    const std::string & node_namespace, const std::string & node_name, GUID_t & guid) const
+  {
+    std::lock_guard<std::mutex> guard(names_mutex_);
+    auto it = node_name_to_guids_.find(std::make_pair(node_namespace, node_name));
+    if (it == node_name_to_guids_.end()) {
+      return false;
     }
+    guid = *it->second.begin();
+    return true;
   }
 
   std::vector<std::string> get_discovered_names() const
@@ -162,31 +376,110 @@ public:
   template<class T>
   void process_discovery_info(T & proxyData, bool is_alive, bool is_reader)
   {
+    // Endpoints of shared participants are attributed to the node announced in
+    // their user data, all other endpoints to their participant.
+    GUID_t node_guid = eprosima::fastrtps::rtps::iHandle2GUID(proxyData.RTPSParticipantKey());
+    bool node_changed = false;
+    {
+      std::string name;
+      std::string namespace_;
+      if (
+        rmw_fastrtps_shared_cpp::get_node_from_user_data(
+          proxyData.guid(), proxyData.m_qos.m_userData.getDataVec(), node_guid, name, namespace_))
+      {
+        std::lock_guard<std::mutex> guard(names_mutex_);
+        node_changed = is_alive ?
+          add_node_reference(node_guid, name, namespace_) :
+          remove_node_reference(node_guid);
+      }
+    }
+    eprosima::fastrtps::rtps::InstanceHandle_t node_key;
+    node_key = node_guid;
+
     auto & topic_cache =
       is_reader ? reader_topic_cache : writer_topic_cache;
+    const std::string topic_name = proxyData.topicName().to_string();
     bool trigger;
     {
       std::lock_guard<std::mutex> guard(topic_cache.getMutex());
       if (is_alive) {
         trigger = topic_cache().addTopic(
-          proxyData.RTPSParticipantKey(),
+          node_key,
           proxyData.guid(),
-          proxyData.topicName().to_string(),
+          topic_name,
           proxyData.typeName().to_string(),
           proxyData.m_qos);
       } else {
         trigger = topic_cache().removeTopic(
-          proxyData.RTPSParticipantKey(),
+          node_key,
           proxyData.guid(),
-          proxyData.topicName().to_string(),
+          topic_name,
           proxyData.typeName().to_string());
       }
+      if (trigger) {
+        topic_cache.markModified();
+      }
     }
     if (trigger) {
-      rmw_fastrtps_shared_cpp::__rmw_trigger_guard_condition(
-        graph_guard_condition_->implementation_identifier,
-        graph_guard_condition_);
+      std::lock_guard<std::mutex> guard(graph_guard_conditions_mutex_);
+      for (auto & guard_condition_topics : graph_guard_conditions_) {
+        if (guard_condition_topics.second.recorded) {
+          guard_condition_topics.second.topics.insert(topic_name);
+        }
+      }
+    }
+    if (trigger || node_changed) {
+      graph_changed();
+    }
+  }
+
+  /**
+   * Get the current version of the graph.
+   *
+   * The version is bumped after every change to the discovered nodes or topic caches,
+   * so two equal versions mean nothing changed in between. Versions start at 1.
+   *
+   * \return the graph version
+   */
+  uint64_t get_graph_version() const
+  {
+    return graph_version_.load();
+  }
+
+  using TopicNamesAndTypes = std::map<std::string, std::set<std::string>>;
+
+  /**
+   * Get the topic names and types computed for a given graph version, if any.
+   *
+   * \param version the graph version the result must have been computed for
+   * \param no_demangle which flavor of the result to get
+   * \return the cached result, or nullptr if it was computed for another version
+   */
+  std::shared_ptr<const TopicNamesAndTypes>
+  get_cached_topic_names_and_types(uint64_t version, bool no_demangle) const
+  {
+    std::lock_guard<std::mutex> guard(query_cache_mutex_);
+    const auto & cached = cached_topic_names_and_types_[no_demangle ? 1 : 0];
+    if (!cached.topics || cached.version != version) {
+      return nullptr;
     }
+    return cached.topics;
+  }
+
+  /**
+   * Remember the topic names and types computed for a given graph version.
+   *
+   * \param version the graph version read before computing the result
+   * \param no_demangle which flavor of the result it is
+   * \param topics the result
+   */
+  void cache_topic_names_and_types(
+    uint64_t version, bool no_demangle, std::shared_ptr<const TopicNamesAndTypes> topics)
+  {
+    std::lock_guard<std::mutex> guard(query_cache_mutex_);
+    auto & cached = cached_topic_names_and_types_[no_demangle ? 1 : 0];
+    cached.version = version;
+    cached.topics = std::move(topics);
   }
 
   using guid_map_t = std::map<eprosima::fastrtps::rtps::GUID_t, std::string>;
@@ -195,7 +488,170 @@ public:
   guid_map_t discovered_namespaces RCPPUTILS_TSA_GUARDED_BY(names_mutex_);
   LockedObject<TopicCache> reader_topic_cache;
   LockedObject<TopicCache> writer_topic_cache;
-  rmw_guard_condition_t * graph_guard_condition_;
+
+private:
+  /**
+   * Count one more user (local registration or endpoint) of a node of a shared participant.
+   *
+   * \return true if the node was not known before
+   */
+  bool add_node_reference(
+    const GUID_t & node_guid, const std::string & name, const std::string & namespace_)
+  RCPPUTILS_TSA_REQUIRES(names_mutex_)
+  {
+    if (0u != node_references_[node_guid]++) {
+      return false;
+    }
+    add_discovered_node(node_guid, name, namespace_);
+    return true;
+  }
+
+  /**
+   * Drop one user of a node of a shared participant.
+   *
+   * \return true if the node is gone
+   */
+  bool remove_node_reference(const GUID_t & node_guid)
+  RCPPUTILS_TSA_REQUIRES(names_mutex_)
+  {
+    auto it = node_references_.find(node_guid);
+    if (it == node_references_.end() || 0u != --it->second) {
+      return false;
+    }
+    node_references_.erase(it);
+    remove_discovered_node(node_guid);
+    return true;
+  }
+
+  void add_discovered_node(
+    const GUID_t & node_guid, const std::string & name, const std::string & namespace_)
+  RCPPUTILS_TSA_REQUIRES(names_mutex_)
+  {
+    discovered_names[node_guid] = name;
+    discovered_namespaces[node_guid] = namespace_;
+    node_name_to_guids_[std::make_pair(namespace_, name)].insert(node_guid);
+  }
+
+  void remove_discovered_node(const GUID_t & node_guid)
+  RCPPUTILS_TSA_REQUIRES(names_mutex_)
+  {
+    auto name_it = discovered_names.find(node_guid);
+    auto ns_it = discovered_namespaces.find(node_guid);
+    if (name_it == discovered_names.end() || ns_it == discovered_namespaces.end()) {
+      return;
+    }
+    auto index_it = node_name_to_guids_.find(std::make_pair(ns_it->second, name_it->second));
+    if (index_it != node_name_to_guids_.end()) {
+      index_it->second.erase(node_guid);
+      if (index_it->second.empty()) {
+        node_name_to_guids_.erase(index_it);
+      }
+    }
+    discovered_names.erase(name_it);
+    discovered_namespaces.erase(ns_it);
+  }
+
+  void graph_changed()
+  {
+    // bump the version first so that woken up waiters see the new one
+    graph_version_.fetch_add(1u);
+    if (graph_notification_period_.count() <= 0) {
+      trigger_graph_guard_conditions();
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> guard(notification_mutex_);
+      notification_pending_ = true;
+    }
+    notification_cv_.notify_one();
+  }
+
+  void trigger_graph_guard_conditions()
+  {
+    std::lock_guard<std::mutex> guard(graph_guard_conditions_mutex_);
+    for (auto & guard_condition_topics : graph_guard_conditions_) {
+      rmw_guard_condition_t * graph_guard_condition = guard_condition_topics.first;
+      rmw_fastrtps_shared_cpp::__rmw_trigger_guard_condition(
+        graph_guard_condition->implementation_identifier,
+        graph_guard_condition);
+    }
+  }
+
+  /**
+   * Trigger the graph guard conditions at most once per notification period.
+   *
+   * The first change starts the period, every other change happening before its end is
+   * reported by the same trigger.
+   */
+  void notification_thread()
+  {
+    std::unique_lock<std::mutex> lock(notification_mutex_);
+    while (!stop_notification_thread_) {
+      notification_cv_.wait(
+        lock, [this]() {
+          return stop_notification_thread_ || notification_pending_;
+        });
+      if (stop_notification_thread_) {
+        break;
+      }
+      notification_cv_.wait_for(
+        lock, graph_notification_period_, [this]() {
+          return stop_notification_thread_;
+        });
+      notification_pending_ = false;
+      lock.unlock();
+      trigger_graph_guard_conditions();
+      lock.lock();
+    }
+  }
+
+  std::map<GUID_t, size_t> node_references_ RCPPUTILS_TSA_GUARDED_BY(names_mutex_);
+
+  struct NodeNameHash
+  {
+    size_t operator()(const std::pair<std::string, std::string> & node_name) const
+    {
+      size_t seed = std::hash<std::string>()(node_name.first);
+      return seed ^ (std::hash<std::string>()(node_name.second) + 0x9e3779b9 +
+             (seed << 6) + (seed >> 2));
+    }
+  };
+
+  // Index of the discovered nodes by (namespace, name), kept in sync with discovered_names.
+  std::unordered_map<std::pair<std::string, std::string>, std::set<GUID_t>, NodeNameHash>
+  node_name_to_guids_ RCPPUTILS_TSA_GUARDED_BY(names_mutex_);
+
+  struct ChangedTopics
+  {
+    // Set by the first take_changed_topics() for the guard condition.
+    bool recorded = false;
+    std::set<std::string> topics;
+  };
+
+  std::mutex graph_guard_conditions_mutex_;
+  // Attached graph guard conditions, with the topics changed since their last take.
+  std::map<rmw_guard_condition_t *, ChangedTopics> graph_guard_conditions_
+    RCPPUTILS_TSA_GUARDED_BY(graph_guard_conditions_mutex_);
+
+  const std::chrono::milliseconds graph_notification_period_;
+  std::mutex notification_mutex_;
+  std::condition_variable notification_cv_;
+  bool notification_pending_ RCPPUTILS_TSA_GUARDED_BY(notification_mutex_) = false;
+  bool stop_notification_thread_ RCPPUTILS_TSA_GUARDED_BY(notification_mutex_) = false;
+  std::thread notification_thread_;
+
+  std::atomic<uint64_t> graph_version_{1u};
+
+  struct CachedTopicNamesAndTypes
+  {
+    uint64_t version = 0u;
+    std::shared_ptr<const TopicNamesAndTypes> topics;
+  };
+
+  mutable std::mutex query_cache_mutex_;
+  // Indexed by no_demangle.
+  CachedTopicNamesAndTypes cached_topic_names_and_types_[2]
+  RCPPUTILS_TSA_GUARDED_BY(query_cache_mutex_);
 };
 
 #endif  // RMW_FASTRTPS_SHARED_CPP__CUSTOM_PARTICIPANT_INFO_HPP_
@@ -18,6 +18,7 @@
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
+#include <memory>
 #include <set>
 
 #include "fastrtps/publisher/Publisher.h"
@@ -28,6 +29,7 @@
 
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_event_info.hpp"
+#include "rmw_fastrtps_shared_cpp/payload_sizing.hpp"
 
 
 class PubListener;
@@ -42,6 +44,8 @@ typedef struct CustomPublisherInfo : public CustomEventInfo
   const void * type_support_impl_;
   rmw_gid_t publisher_gid;
   const char * typesupport_identifier_;
+  // Only set for unbounded types in PREALLOCATED_WITH_REALLOC_MEMORY_MODE
+  std::unique_ptr<rmw_fastrtps_shared_cpp::PayloadSizing> payload_sizing_;
 
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   EventListenerInterface *
@@ -0,0 +1,43 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__ENV_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__ENV_HPP_
+
+#include <cstdint>
+
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Read a non negative integer from an environment variable.
+/**
+ * An invalid value is ignored with a warning, which says what is done instead.
+ *
+ * \param[in] env_var name of the environment variable
+ * \param[in] max_value largest valid value
+ * \param[in] fallback what is done when the value is ignored, for the warning
+ * \param[out] value value of the variable, only set when it is valid
+ * \return true if the variable is set to a valid value
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+bool
+get_env_uint(
+  const char * env_var, uint64_t max_value, const char * fallback, uint64_t & value);
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__ENV_HPP_
@@ -0,0 +1,118 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__GENERATED_SERIALIZATION_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__GENERATED_SERIALIZATION_HPP_
+
+#include <fastcdr/Cdr.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "rosidl_typesupport_fastrtps_cpp/message_type_support.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/**
+ * Serialization of ROS messages with the code generated by rosidl_typesupport_fastrtps_c/cpp.
+ *
+ * Shared by the type supports of rmw_fastrtps_cpp and the generated message type supports of
+ * rmw_fastrtps_dynamic_cpp, which only differ by where they get the callbacks from.
+ */
+class GeneratedSerialization
+{
+public:
+  /// Compute the serialized size of a type.
+  /**
+   * \param callbacks generated functions of the type.
+   * \param[out] is_bounded whether every message of the type fits in the returned size.
+   * \return the serialized size of the largest message, encapsulation included, when bounded.
+   */
+  uint32_t init(const message_type_support_callbacks_t * callbacks, bool & is_bounded)
+  {
+    // Fully bound by default
+    is_bounded = true;
+    auto data_size = static_cast<uint32_t>(callbacks->max_serialized_size(is_bounded));
+
+    // A fully bound message of size 0 is an empty message
+    if (is_bounded && (data_size == 0) ) {
+      has_data_ = false;
+      ++data_size;  // Dummy byte
+    } else {
+      has_data_ = true;
+    }
+
+    // Total size is encapsulation size + data size
+    return 4 + data_size;
+  }
+
+  size_t getEstimatedSerializedSize(
+    const message_type_support_callbacks_t * callbacks, const void * ros_message) const
+  {
+    assert(ros_message);
+
+    // Encapsulation size + message size
+    return 4 + callbacks->get_serialized_size(ros_message);
+  }
+
+  bool serialize(
+    const message_type_support_callbacks_t * callbacks, const void * ros_message,
+    eprosima::fastcdr::Cdr & ser) const
+  {
+    assert(ros_message);
+
+    // Serialize encapsulation
+    ser.serialize_encapsulation();
+
+    // If type is not empty, serialize message
+    if (has_data_) {
+      return callbacks->cdr_serialize(ros_message, ser);
+    }
+
+    // Otherwise, add a dummy byte
+    ser << (uint8_t)0;
+    return true;
+  }
+
+  bool deserialize(
+    const message_type_support_callbacks_t * callbacks, eprosima::fastcdr::Cdr & deser,
+    void * ros_message) const
+  {
+    assert(ros_message);
+
+    // Deserialize encapsulation.
+    deser.read_encapsulation();
+
+    // If type is not empty, deserialize message
+    if (has_data_) {
+      return callbacks->cdr_deserialize(deser, ros_message);
+    }
+
+    // Otherwise, consume dummy byte
+    uint8_t dump = 0;
+    deser >> dump;
+    (void)dump;
+
+    return true;
+  }
+
+private:
+  bool has_data_ = true;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__GENERATED_SERIALIZATION_HPP_
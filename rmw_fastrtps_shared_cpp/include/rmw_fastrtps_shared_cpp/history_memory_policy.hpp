@@ -0,0 +1,68 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__HISTORY_MEMORY_POLICY_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__HISTORY_MEMORY_POLICY_HPP_
+
+#include <cstdint>
+#include <string>
+
+#include "fastrtps/rtps/resources/ResourceManagement.h"
+
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Largest serialized size of a bounded type whose history is fully preallocated by default.
+/**
+ * The history preallocates its payloads with that size, beyond it the memory used would be
+ * out of proportion with the size of most messages.
+ */
+constexpr uint32_t max_preallocated_type_size = 64 * 1024;
+
+/// Parse the name of a history memory policy.
+/**
+ * \param[in] name PREALLOCATED, PREALLOCATED_WITH_REALLOC or DYNAMIC
+ * \param[out] policy the corresponding memory policy
+ * \return false if the name is unknown
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+bool
+parse_history_memory_policy(
+  const std::string & name,
+  eprosima::fastrtps::rtps::MemoryManagementPolicy_t & policy);
+
+/// History memory policy of a publisher or a subscription.
+/**
+ * Types whose messages all fit in type_size bytes get PREALLOCATED_MEMORY_MODE, so that their
+ * payloads are allocated once with exactly that size, up to max_preallocated_type_size.
+ * Other types get PREALLOCATED_WITH_REALLOC_MEMORY_MODE, whose payloads are allocated once,
+ * reused, and only grown when a larger message lands in them.
+ *
+ * The RMW_FASTRTPS_HISTORY_MEMORY_POLICY environment variable overrides this per topic, as a
+ * topic configuration (see match_topic_config()) of policy names, like
+ * "/arm/joint*=PREALLOCATED,/map=DYNAMIC".
+ *
+ * \param[in] topic_name ROS name of the topic
+ * \param[in] is_bounded whether every message of the type fits in type_size bytes
+ * \param[in] type_size serialized size of the type, the largest one if it is bounded
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+eprosima::fastrtps::rtps::MemoryManagementPolicy_t
+get_history_memory_policy(const char * topic_name, bool is_bounded, uint32_t type_size);
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__HISTORY_MEMORY_POLICY_HPP_
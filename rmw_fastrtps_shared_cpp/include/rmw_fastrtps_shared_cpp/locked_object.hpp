@@ -15,6 +15,9 @@
 #ifndef RMW_FASTRTPS_SHARED_CPP__LOCKED_OBJECT_HPP_
 #define RMW_FASTRTPS_SHARED_CPP__LOCKED_OBJECT_HPP_
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 
 #include "rcpputils/thread_safety_annotations.hpp"
@@ -23,8 +26,24 @@ template<class T>
 class LockedObject
 {
 private:
+  struct Snapshot
+  {
+    uint64_t version;
+    std::shared_ptr<const T> object;
+  };
+
   mutable std::mutex mutex_;
-  T object_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  // Never null, may be shared with the last published snapshot, see operator()().
+  std::shared_ptr<T> object_ RCPPUTILS_TSA_GUARDED_BY(mutex_) = std::make_shared<T>();
+  // True while object_ is shared with the last published snapshot.
+  mutable bool published_ RCPPUTILS_TSA_GUARDED_BY(mutex_) = true;
+
+  // Incremented by every writer, see markModified().
+  std::atomic<uint64_t> version_{0u};
+
+  // Only accessed through std::atomic_load() and std::atomic_store().
+  mutable std::shared_ptr<const Snapshot> snapshot_ =
+    std::make_shared<const Snapshot>(Snapshot{0u, object_});
 
 public:
   /**
@@ -35,14 +54,61 @@ public:
     return mutex_;
   }
 
+  /**
+  * Get the object to modify.
+  *
+  * The first call after a snapshot was published copies the object, so that snapshots
+  * stay immutable; the next calls return the same copy until another snapshot is published.
+  */
   T & operator()()
   {
-    return object_;
+    if (published_) {
+      object_ = std::make_shared<T>(*object_);
+      published_ = false;
+    }
+    return *object_;
   }
 
   const T & operator()() const
   {
-    return object_;
+    return *object_;
+  }
+
+  /**
+  * Record that the object was modified, invalidating the current snapshot.
+  *
+  * Must be called with the mutex held, after the modification.
+  */
+  void markModified() RCPPUTILS_TSA_REQUIRES(mutex_)
+  {
+    version_.fetch_add(1u);
+  }
+
+  /**
+  * Get an immutable copy of the object which can be read without holding the mutex.
+  *
+  * Snapshots are shared by all the readers until the next modification.
+  * The first reader after a modification takes the mutex to publish the object as is,
+  * and the next writer copies it once; so a burst of modifications costs a single copy,
+  * however many there are, and readers never copy.
+  *
+  * \return the snapshot reflecting the last call to markModified()
+  */
+  std::shared_ptr<const T> getSnapshot() const
+  {
+    std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&snapshot_);
+    if (snapshot->version != version_.load()) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      // another reader may have published it while we were waiting
+      snapshot = std::atomic_load(&snapshot_);
+      const uint64_t version = version_.load();
+      if (snapshot->version != version) {
+        snapshot = std::make_shared<const Snapshot>(Snapshot{version, object_});
+        published_ = true;
+        std::atomic_store(&snapshot_, snapshot);
+      }
+    }
+    return snapshot->object;
   }
 };
 
@@ -0,0 +1,110 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__PAYLOAD_SIZING_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__PAYLOAD_SIZING_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#include "fastrtps/rtps/common/SerializedPayload.h"
+
+#include "rcpputils/thread_safety_annotations.hpp"
+
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Counters of the payloads reserved by a publisher.
+struct PayloadSizingStats
+{
+  // Samples written.
+  uint64_t samples;
+  // Payloads of the writer history grown to fit a sample.
+  uint64_t reallocations;
+  // Payloads which would have been grown if each were reserved for the exact size of its sample.
+  uint64_t reallocations_without_presizing;
+  // Size currently reserved for a sample, at least the high water mark of the recent ones.
+  uint32_t reserved_size;
+};
+
+/**
+ * Presizing of the payloads of a publisher of an unbounded type.
+ *
+ * With PREALLOCATED_WITH_REALLOC_MEMORY_MODE, each payload in the writer history starts with
+ * the size of the type and is reallocated whenever a larger sample lands in it.
+ * Reserving the largest size among the recent samples instead, each payload is grown once to
+ * that high water mark rather than step by step.
+ * The high water mark forgets the samples older than two windows, so that a single spike
+ * does not inflate the history for ever.
+ */
+class PayloadSizing
+{
+public:
+  /// \param initial_size size of the payloads when the writer history is created.
+  /// \param window number of samples after which the high water mark starts decaying.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  PayloadSizing(uint32_t initial_size, uint32_t window);
+
+  /// Size to reserve for a sample serialized in size bytes.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  uint32_t
+  reserve(uint32_t size);
+
+  /// Account for the payload reserved for the last sample, before the sample is written to it.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  void
+  on_reserved(const eprosima::fastrtps::rtps::SerializedPayload_t & payload);
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  PayloadSizingStats
+  stats() const;
+
+private:
+  struct PayloadCapacity
+  {
+    // Capacity of the payload when it was last used.
+    uint32_t actual;
+    // Capacity it would have if every sample were reserved its exact size.
+    uint32_t exact;
+  };
+
+  const uint32_t initial_size_;
+  const uint32_t window_;
+
+  mutable std::mutex mutex_;
+  uint32_t last_size_ RCPPUTILS_TSA_GUARDED_BY(mutex_) = 0;
+  uint32_t last_reserved_ RCPPUTILS_TSA_GUARDED_BY(mutex_) = 0;
+  uint32_t window_samples_ RCPPUTILS_TSA_GUARDED_BY(mutex_) = 0;
+  uint32_t window_max_ RCPPUTILS_TSA_GUARDED_BY(mutex_) = 0;
+  uint32_t previous_window_max_ RCPPUTILS_TSA_GUARDED_BY(mutex_) = 0;
+  // Keyed by address, the payloads of the writer history never move
+  std::unordered_map<const void *, PayloadCapacity> payloads_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  PayloadSizingStats stats_ RCPPUTILS_TSA_GUARDED_BY(mutex_) {0, 0, 0, 0};
+};
+
+/// Number of samples of the payload sizing window, 0 if payloads are not presized.
+/**
+ * Read once from the RMW_FASTRTPS_PAYLOAD_SIZING_WINDOW environment variable, defaults to 64.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+uint32_t
+get_payload_sizing_window();
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__PAYLOAD_SIZING_HPP_
@@ -0,0 +1,58 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__PUBLISH_MODE_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__PUBLISH_MODE_HPP_
+
+#include <string>
+
+#include "fastrtps/qos/QosPolicies.h"
+
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Parse the name of a publish mode.
+/**
+ * \param[in] name SYNCHRONOUS or ASYNCHRONOUS
+ * \param[out] kind the corresponding publish mode
+ * \return false if the name is unknown
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+bool
+parse_publish_mode(
+  const std::string & name,
+  eprosima::fastrtps::PublishModeQosPolicyKind & kind);
+
+/// Publish mode of a publisher, of the responses of a service or of the requests of a client.
+/**
+ * ASYNCHRONOUS_PUBLISH_MODE by default: samples are handed to the thread of the writer, which
+ * sends them and fragments those larger than the transport allows.
+ * SYNCHRONOUS_PUBLISH_MODE sends samples on the calling thread, saving the handoff and wakeup
+ * of that thread, but fails to publish samples which would need to be fragmented.
+ *
+ * The RMW_FASTRTPS_PUBLISH_MODE environment variable overrides this per topic or service, as a
+ * topic configuration (see match_topic_config()) of mode names, like
+ * "/cmd_vel=SYNCHRONOUS,/arm/joint*=SYNCHRONOUS".
+ *
+ * \param[in] name ROS name of the topic or the service
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+eprosima::fastrtps::PublishModeQosPolicyKind
+get_publish_mode(const char * name);
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__PUBLISH_MODE_HPP_
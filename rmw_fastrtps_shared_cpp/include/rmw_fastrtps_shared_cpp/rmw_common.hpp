@@ -15,6 +15,12 @@
 #ifndef RMW_FASTRTPS_SHARED_CPP__RMW_COMMON_HPP_
 #define RMW_FASTRTPS_SHARED_CPP__RMW_COMMON_HPP_
 
+#include <string>
+#include <vector>
+
+#include "fastrtps/rtps/common/SerializedPayload.h"
+
+#include "./payload_sizing.hpp"
 #include "./visibility_control.h"
 
 #include "rmw/error_handling.h"
@@ -87,6 +93,7 @@ RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_node_t *
 __rmw_create_node(
   const char * identifier,
+  rmw_context_t * context,
   const char * name,
   const char * namespace_,
   size_t domain_id,
@@ -167,6 +174,21 @@ __rmw_publisher_get_actual_qos(
   const rmw_publisher_t * publisher,
   rmw_qos_profile_t * qos);
 
+/**
+ * Get the counters of the payloads reserved by a publisher of an unbounded type.
+ *
+ * \param identifier of the rmw implementation
+ * \param publisher to get the counters of
+ * \param stats [out] the counters, all 0 if the payloads of the publisher are not presized
+ * \return RMW_RET_OK if successful
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_publisher_get_payload_sizing_stats(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  PayloadSizingStats & stats);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_ret_t
 __rmw_send_request(
@@ -331,6 +353,26 @@ __rmw_take_serialized_message_with_info(
   rmw_message_info_t * message_info,
   rmw_subscription_allocation_t * allocation);
 
+/// Take the next sample of a subscription as is, without copying nor deserializing it.
+/**
+ * The buffer holding the received sample is swapped with the one of `payload`, which is
+ * grown first if needed, so Fast-RTPS keeps a buffer at least as large as the one it had.
+ * \param identifier implementation identifier of the subscription.
+ * \param subscription subscription to take from.
+ * \param payload receives the sample, its encapsulation included.
+ * \param taken set to true if a sample was taken.
+ * \param message_info filled when a sample was taken, may be nullptr.
+ * \return RMW_RET_OK, or RMW_RET_ERROR if any argument is invalid.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_take_payload(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  eprosima::fastrtps::rtps::SerializedPayload_t * payload,
+  bool * taken,
+  rmw_message_info_t * message_info);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_ret_t
 __rmw_get_topic_names_and_types(
@@ -340,6 +382,25 @@ __rmw_get_topic_names_and_types(
   bool no_demangle,
   rmw_names_and_types_t * topic_names_and_types);
 
+/**
+ * Get the topics and services on which endpoints appeared or went away since the
+ * last call for this node.
+ *
+ * Topics are reported with their ROS name, services with their service name and
+ * other DDS topics with their DDS name.
+ *
+ * \param identifier of the rmw implementation
+ * \param node to get the changes seen by
+ * \param topic_names [out] the changed names, in no particular order
+ * \return RMW_RET_OK if successful
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_take_changed_topics(
+  const char * identifier,
+  const rmw_node_t * node,
+  std::vector<std::string> & topic_names);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_ret_t
 __rmw_wait(
@@ -0,0 +1,62 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__RMW_CONTEXT_IMPL_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__RMW_CONTEXT_IMPL_HPP_
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "fastrtps/participant/Participant.h"
+
+#include "rcpputils/thread_safety_annotations.hpp"
+
+class ParticipantListener;
+
+/**
+ * A Fast-RTPS participant owned by a context and shared by all of its nodes
+ * that were created with the same domain id, localhost and security settings.
+ */
+struct SharedParticipantInfo
+{
+  eprosima::fastrtps::Participant * participant;
+  ::ParticipantListener * listener;
+
+  // See CustomParticipantInfo::leave_middleware_default_qos.
+  bool leave_middleware_default_qos;
+
+  // Number of nodes currently using this participant.
+  size_t node_count;
+
+  // Used to give every node of this participant a distinct GUID.
+  uint32_t next_node_id;
+};
+
+/**
+ * Participants are shared between nodes which agree on all of
+ * domain id, localhost_only, security root path and enforce_security.
+ */
+using SharedParticipantKey = std::tuple<size_t, bool, std::string, bool>;
+
+struct rmw_context_impl_t
+{
+  std::mutex mutex;
+  std::map<SharedParticipantKey, SharedParticipantInfo> participants
+    RCPPUTILS_TSA_GUARDED_BY(mutex);
+};
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__RMW_CONTEXT_IMPL_HPP_
@@ -32,9 +32,25 @@
 
 #include "locked_object.hpp"
 #include "qos.hpp"
+#include "visibility_control.h"
 
 typedef eprosima::fastrtps::rtps::GUID_t GUID_t;
 
+/**
+ * What a DDS topic is used for from the ROS point of view.
+ */
+enum class TopicKind
+{
+  // Not a ROS topic, or a malformed service topic.
+  Other,
+  // A ROS topic, prefixed with rt/.
+  Topic,
+  // The request topic of a ROS service, prefixed with rq/.
+  Request,
+  // The reply topic of a ROS service, prefixed with rr/.
+  Reply,
+};
+
 /**
  * A data structure that encapsulates all the data associated with a publisher
  * or subscription by the topic it publishes or subscribes to
@@ -45,8 +61,28 @@ struct TopicData
   GUID_t entity_guid;
   std::string topic_type;
   rmw_qos_profile_t qos_profile;
+
+  // The fields below are derived from the DDS topic name and type when the topic is
+  // discovered, so that graph queries do not have to demangle them again.
+  TopicKind kind;
+  // The ROS topic name for topics, the service name for requests and replies,
+  // the DDS topic name otherwise.
+  std::string ros_name;
+  // The ROS message type for topics, the service type for requests and replies
+  // (empty if it is not a ROS service type), the demangled type otherwise.
+  std::string ros_type;
 };
 
+/**
+ * Classify a DDS topic and fill in the demangled fields of its topic data.
+ *
+ * \param topic_name the DDS topic name
+ * \param topic_data [in/out] topic data whose topic_type is already set
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+_demangle_topic_data(const std::string & topic_name, TopicData & topic_data);
+
 /**
  * Topic cache data structure. Manages relationships between participants and topics.
  */
@@ -54,8 +90,8 @@ class TopicCache
 {
 private:
   using TopicToTypes = std::unordered_map<std::string, std::vector<std::string>>;
-  using ParticipantTopicMap = std::map<GUID_t, TopicToTypes>;
   using TopicNameToTopicData = std::unordered_map<std::string, std::vector<TopicData>>;
+  using ParticipantTopicMap = std::map<GUID_t, TopicNameToTopicData>;
 
   /**
    * Map of topic names to TopicData. Where topic data is vector of tuples containing
@@ -68,53 +104,10 @@ private:
   TopicNameToTopicData topic_name_to_topic_data_;
 
   /**
-   * Map of participant GUIDS to a set of topic-type.
+   * Map of participant GUIDS to the data of the topics they use.
    */
   ParticipantTopicMap participant_to_topics_;
 
-  /**
-   * Helper function to initialize an empty TopicData for a topic name.
-   *
-   * \param topic_name the topic name for which the TopicNameToTopicData map should be initialized.
-   * \param topic_name_to_topic_data the map to initialize.
-   */
-  void initializeTopicDataMap(
-    const std::string & topic_name,
-    TopicNameToTopicData & topic_name_to_topic_data)
-  {
-    if (topic_name_to_topic_data.find(topic_name) == topic_name_to_topic_data.end()) {
-      topic_name_to_topic_data[topic_name] = std::vector<TopicData>();
-    }
-  }
-
-  /**
-    * Helper function to initialize a topic vector.
-    *
-    * \param topic_name the topic name for which the TopicToTypes map should be initialized.
-    * \param topic_to_types the map to initialize.
-    */
-  void initializeTopicTypesMap(const std::string & topic_name, TopicToTypes & topic_to_types)
-  {
-    if (topic_to_types.find(topic_name) == topic_to_types.end()) {
-      topic_to_types[topic_name] = std::vector<std::string>();
-    }
-  }
-
-  /**
-   * Helper function to initialize the set inside a participant map.
-   *
-   * \param map
-   * \param guid
-   */
-  void initializeParticipantMap(
-    ParticipantTopicMap & map,
-    GUID_t guid)
-  {
-    if (map.find(guid) == map.end()) {
-      map[guid] = TopicToTypes();
-    }
-  }
-
 public:
   /**
    * \return a map of topic name to the vector of topic types used.
@@ -132,7 +125,7 @@ public:
   }
 
   /**
-   * \return a map of participant guid to the vector of topic names used.
+   * \return a map of participant guid to the topic names used and their data.
    */
   const ParticipantTopicMap & getParticipantToTopics() const
   {
@@ -165,10 +158,7 @@ public:
     const std::string & type_name,
     const T & dds_qos)
   {
-    initializeTopicDataMap(topic_name, topic_name_to_topic_data_);
     auto participant_guid = iHandle2GUID(rtpsParticipantKey);
-    initializeParticipantMap(participant_to_topics_, participant_guid);
-    initializeTopicTypesMap(topic_name, participant_to_topics_[entity_guid]);
     if (
       rcutils_logging_logger_is_enabled_for(
         "rmw_fastrtps_shared_cpp", RCUTILS_LOG_SEVERITY_DEBUG))
@@ -186,10 +176,14 @@ public:
       participant_guid,
       entity_guid,
       type_name,
-      qos_profile
+      qos_profile,
+      TopicKind::Other,
+      std::string(),
+      std::string()
     };
+    _demangle_topic_data(topic_name, topic_data);
     topic_name_to_topic_data_[topic_name].push_back(topic_data);
-    participant_to_topics_[participant_guid][topic_name].push_back(type_name);
+    participant_to_topics_[participant_guid][topic_name].push_back(std::move(topic_data));
     return true;
   }
 
@@ -234,7 +228,13 @@ public:
       guid_topics_pair->second.find(topic_name) != guid_topics_pair->second.end())
     {
       auto & type_vec = guid_topics_pair->second[topic_name];
-      type_vec.erase(std::find(type_vec.begin(), type_vec.end(), type_name));
+      type_vec.erase(
+        std::find_if(
+          type_vec.begin(), type_vec.end(),
+          [&type_name, &entity_guid](const auto & topic_data) {
+            return type_name.compare(topic_data.topic_type) == 0 &&
+            entity_guid == topic_data.entity_guid;
+          }));
       if (type_vec.empty()) {
         participant_to_topics_[participant_guid].erase(topic_name);
       }
@@ -262,9 +262,9 @@ inline std::ostream & operator<<(
     stream << "  Topics: " << std::endl;
     for (auto & types : elem.second) {
       stream << "    " << types.first << ": ";
-      std::copy(
-        types.second.begin(), types.second.end(),
-        std::ostream_iterator<std::string>(stream, ","));
+      for (auto & topic_data : types.second) {
+        stream << topic_data.topic_type << ",";
+      }
       stream << std::endl;
     }
     map_ss << elem.first << std::endl << stream.str();
@@ -0,0 +1,52 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__TOPIC_CONFIG_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__TOPIC_CONFIG_HPP_
+
+#include <string>
+
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Value of the first entry of a topic configuration whose pattern matches a topic name.
+/**
+ * A topic configuration is a comma separated list of pattern=value entries, like
+ * "/cmd_vel=A,/arm/joint*=B,*=C".
+ * A pattern matches either the topic name itself, or, when it ends with '*', every topic name
+ * starting with what precedes the '*'.
+ *
+ * \param[in] config topic configuration
+ * \param[in] topic_name ROS name of the topic
+ * \return the value of the matching entry, empty if there is none
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+std::string
+match_topic_config(const std::string & config, const std::string & topic_name);
+
+/// Value of the first entry of the topic configuration held by an environment variable.
+/**
+ * \param[in] env_var name of the environment variable
+ * \param[in] topic_name ROS name of the topic
+ * \return the value of the matching entry, empty if there is none or the variable is unset
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+std::string
+get_topic_config(const char * env_var, const std::string & topic_name);
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__TOPIC_CONFIG_HPP_
@@ -15,9 +15,13 @@
 #include <fastcdr/FastBuffer.h>
 #include <fastcdr/Cdr.h>
 #include <cassert>
+#include <new>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "rmw/serialized_message.h"
+
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 namespace rmw_fastrtps_shared_cpp
@@ -42,12 +46,30 @@ void * TypeSupport::createData()
 
 bool TypeSupport::serialize(
   void * data, eprosima::fastrtps::rtps::SerializedPayload_t * payload)
+{
+  return serialize(this, data, payload);
+}
+
+bool TypeSupport::serialize(
+  const TypeSupport * type, void * data, eprosima::fastrtps::rtps::SerializedPayload_t * payload)
 {
   assert(data);
   assert(payload);
 
   auto ser_data = static_cast<SerializedData *>(data);
-  if (ser_data->is_cdr_buffer) {
+  if (ser_data->payload_sizing) {
+    ser_data->payload_sizing->on_reserved(*payload);
+  }
+  if (ser_data->serialized_message) {
+    auto serialized_message = ser_data->serialized_message;
+    if (payload->max_size >= serialized_message->buffer_length) {
+      payload->length = static_cast<uint32_t>(serialized_message->buffer_length);
+      payload->encapsulation = eprosima::fastcdr::Cdr::DEFAULT_ENDIAN ==
+        eprosima::fastcdr::Cdr::BIG_ENDIANNESS ? CDR_BE : CDR_LE;
+      memcpy(payload->data, serialized_message->buffer, serialized_message->buffer_length);
+      return true;
+    }
+  } else if (ser_data->is_cdr_buffer) {
     auto ser = static_cast<eprosima::fastcdr::Cdr *>(ser_data->data);
     if (payload->max_size >= ser->getSerializedDataLength()) {
       payload->length = static_cast<uint32_t>(ser->getSerializedDataLength());
@@ -62,7 +84,7 @@ bool TypeSupport::serialize(
       payload->max_size);  // Object that manages the raw buffer.
     eprosima::fastcdr::Cdr ser(fastbuffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
       eprosima::fastcdr::Cdr::DDS_CDR);  // Object that serializes the data.
-    if (this->serializeROSmessage(ser_data->data, ser, ser_data->impl)) {
+    if (type->serializeROSmessage(ser_data->data, ser, ser_data->impl)) {
       payload->encapsulation = ser.endianness() ==
         eprosima::fastcdr::Cdr::BIG_ENDIANNESS ? CDR_BE : CDR_LE;
       payload->length = (uint32_t)ser.getSerializedDataLength();
@@ -76,11 +98,46 @@ bool TypeSupport::serialize(
 bool TypeSupport::deserialize(
   eprosima::fastrtps::rtps::SerializedPayload_t * payload,
   void * data)
+{
+  return deserialize(this, payload, data);
+}
+
+bool TypeSupport::deserialize(
+  const TypeSupport * type,
+  eprosima::fastrtps::rtps::SerializedPayload_t * payload,
+  void * data)
 {
   assert(data);
   assert(payload);
 
   auto ser_data = static_cast<SerializedData *>(data);
+  if (ser_data->retained_payload) {
+    // Both buffers are allocated by SerializedPayload_t, Fast-RTPS gets one at least as large
+    // as the one it gave away back in its history.
+    auto retained = ser_data->retained_payload;
+    try {
+      retained->reserve(payload->max_size);
+    } catch (const std::bad_alloc &) {
+      return false;
+    }
+    std::swap(retained->data, payload->data);
+    std::swap(retained->max_size, payload->max_size);
+    retained->length = payload->length;
+    retained->encapsulation = payload->encapsulation;
+    payload->length = 0;
+    return true;
+  }
+  if (ser_data->serialized_message) {
+    auto serialized_message = ser_data->serialized_message;
+    if (serialized_message->buffer_capacity < payload->length &&
+      rmw_serialized_message_resize(serialized_message, payload->length) != RMW_RET_OK)
+    {
+      return false;
+    }
+    memcpy(serialized_message->buffer, payload->data, payload->length);
+    serialized_message->buffer_length = payload->length;
+    return true;
+  }
   if (ser_data->is_cdr_buffer) {
     auto buffer = static_cast<eprosima::fastcdr::FastBuffer *>(ser_data->data);
     if (!buffer->reserve(payload->length)) {
@@ -97,24 +154,38 @@ bool TypeSupport::deserialize(
     fastbuffer,
     eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
     eprosima::fastcdr::Cdr::DDS_CDR);
-  return deserializeROSmessage(deser, ser_data->data, ser_data->impl);
+  return type->deserializeROSmessage(deser, ser_data->data, ser_data->impl);
 }
 
 std::function<uint32_t()> TypeSupport::getSerializedSizeProvider(void * data)
+{
+  return getSerializedSizeProvider(this, data);
+}
+
+std::function<uint32_t()> TypeSupport::getSerializedSizeProvider(
+  const TypeSupport * type, void * data)
 {
   assert(data);
 
   auto ser_data = static_cast<SerializedData *>(data);
-  auto ser_size = [this, ser_data]() -> uint32_t
+  auto ser_size = [type, ser_data]() -> uint32_t
     {
-      if (ser_data->is_cdr_buffer) {
+      uint32_t size = 0;
+      if (ser_data->serialized_message) {
+        size = static_cast<uint32_t>(ser_data->serialized_message->buffer_length);
+      } else if (ser_data->is_cdr_buffer) {
         auto ser = static_cast<eprosima::fastcdr::Cdr *>(ser_data->data);
-        return static_cast<uint32_t>(ser->getSerializedDataLength());
+        size = static_cast<uint32_t>(ser->getSerializedDataLength());
+      } else {
+        size = static_cast<uint32_t>(
+          type->getEstimatedSerializedSize(
+            ser_data->data,
+            ser_data->impl));
+      }
+      if (ser_data->payload_sizing) {
+        return ser_data->payload_sizing->reserve(size);
       }
-      return static_cast<uint32_t>(
-        this->getEstimatedSerializedSize(
-          ser_data->data,
-          ser_data->impl));
+      return size;
     };
   return ser_size;
 }
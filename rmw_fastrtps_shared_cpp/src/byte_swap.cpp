@@ -0,0 +1,197 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RMW_FASTRTPS_BYTE_SWAP_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__)
+// Only GCC and Clang can build AVX2 code without building everything for AVX2
+#define RMW_FASTRTPS_BYTE_SWAP_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define RMW_FASTRTPS_BYTE_SWAP_NEON
+#include <arm_neon.h>
+#endif
+
+#include "rmw_fastrtps_shared_cpp/byte_swap.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+namespace
+{
+
+inline uint16_t swap(uint16_t value)
+{
+  return static_cast<uint16_t>((value << 8) | (value >> 8));
+}
+
+inline uint32_t swap(uint32_t value)
+{
+  return ((value & 0x000000FFu) << 24) | ((value & 0x0000FF00u) << 8) |
+         ((value & 0x00FF0000u) >> 8) | ((value & 0xFF000000u) >> 24);
+}
+
+inline uint64_t swap(uint64_t value)
+{
+  return (static_cast<uint64_t>(swap(static_cast<uint32_t>(value))) << 32) |
+         swap(static_cast<uint32_t>(value >> 32));
+}
+
+// Go through memcpy, the array may not be aligned
+template<typename T>
+void swap_scalar(T * data, size_t count)
+{
+  for (size_t i = 0; i < count; ++i) {
+    T value;
+    memcpy(&value, data + i, sizeof(T));
+    value = swap(value);
+    memcpy(data + i, &value, sizeof(T));
+  }
+}
+
+#ifdef RMW_FASTRTPS_BYTE_SWAP_AVX2
+__attribute__((target("avx2")))
+size_t swap_avx2(uint8_t * data, size_t size, size_t element_size)
+{
+  // Byte indexes reversing each 2, 4 or 8 byte element of a 128 bit lane
+  const __m256i masks[3] = {
+    _mm256_setr_epi8(
+      1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+      1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14),
+    _mm256_setr_epi8(
+      3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+      3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12),
+    _mm256_setr_epi8(
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8),
+  };
+  const __m256i mask = masks[element_size == 2 ? 0 : (element_size == 4 ? 1 : 2)];
+  size_t offset = 0;
+  for (; offset + 32 <= size; offset += 32) {
+    __m256i * block = reinterpret_cast<__m256i *>(data + offset);
+    _mm256_storeu_si256(block, _mm256_shuffle_epi8(_mm256_loadu_si256(block), mask));
+  }
+  return offset;
+}
+
+bool has_avx2()
+{
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+#endif
+
+#ifdef RMW_FASTRTPS_BYTE_SWAP_SSE2
+// Swap the two bytes of every 16 bit word
+inline __m128i swap_words_sse2(__m128i block)
+{
+  return _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+}
+
+size_t swap_sse2(uint8_t * data, size_t size, size_t element_size)
+{
+  size_t offset = 0;
+  for (; offset + 16 <= size; offset += 16) {
+    __m128i * pointer = reinterpret_cast<__m128i *>(data + offset);
+    __m128i block = _mm_loadu_si128(pointer);
+    // First reverse the 16 bit words of each element, then the bytes of each word
+    if (element_size == 4) {
+      block = _mm_shufflelo_epi16(block, _MM_SHUFFLE(2, 3, 0, 1));
+      block = _mm_shufflehi_epi16(block, _MM_SHUFFLE(2, 3, 0, 1));
+    } else if (element_size == 8) {
+      block = _mm_shufflelo_epi16(block, _MM_SHUFFLE(0, 1, 2, 3));
+      block = _mm_shufflehi_epi16(block, _MM_SHUFFLE(0, 1, 2, 3));
+    }
+    _mm_storeu_si128(pointer, swap_words_sse2(block));
+  }
+  return offset;
+}
+#endif
+
+#ifdef RMW_FASTRTPS_BYTE_SWAP_NEON
+size_t swap_neon(uint8_t * data, size_t size, size_t element_size)
+{
+  size_t offset = 0;
+  for (; offset + 16 <= size; offset += 16) {
+    uint8x16_t block = vld1q_u8(data + offset);
+    if (element_size == 2) {
+      block = vrev16q_u8(block);
+    } else if (element_size == 4) {
+      block = vrev32q_u8(block);
+    } else {
+      block = vrev64q_u8(block);
+    }
+    vst1q_u8(data + offset, block);
+  }
+  return offset;
+}
+#endif
+
+/// Swap as many whole vectors as possible, return the number of bytes swapped.
+size_t swap_vectorized(uint8_t * data, size_t size, size_t element_size)
+{
+  size_t offset = 0;
+#ifdef RMW_FASTRTPS_BYTE_SWAP_AVX2
+  if (has_avx2()) {
+    offset = swap_avx2(data, size, element_size);
+  }
+#endif
+#if defined(RMW_FASTRTPS_BYTE_SWAP_SSE2)
+  offset += swap_sse2(data + offset, size - offset, element_size);
+#elif defined(RMW_FASTRTPS_BYTE_SWAP_NEON)
+  offset += swap_neon(data + offset, size - offset, element_size);
+#else
+  (void)data;
+  (void)size;
+  (void)element_size;
+#endif
+  return offset;
+}
+
+template<typename T>
+void swap_array(T * data, size_t count)
+{
+  const size_t swapped = swap_vectorized(
+    reinterpret_cast<uint8_t *>(data), count * sizeof(T), sizeof(T)) / sizeof(T);
+  swap_scalar(data + swapped, count - swapped);
+}
+
+}  // namespace
+
+void
+byte_swap_16(uint16_t * data, size_t count)
+{
+  swap_array(data, count);
+}
+
+void
+byte_swap_32(uint32_t * data, size_t count)
+{
+  swap_array(data, count);
+}
+
+void
+byte_swap_64(uint64_t * data, size_t count)
+{
+  swap_array(data, count);
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
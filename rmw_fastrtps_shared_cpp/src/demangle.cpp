@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "rcpputils/find_and_replace.hpp"
@@ -21,6 +22,7 @@
 #include "rcutils/types.h"
 
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
+#include "rmw_fastrtps_shared_cpp/topic_cache.hpp"
 
 /// Return the demangle ROS topic or the original if not a ROS topic.
 std::string
@@ -154,3 +156,31 @@ _demangle_service_type_only(const std::string & dds_type_name)
   std::string type_name = dds_type_name.substr(start, suffix_position - start);
   return type_namespace + type_name;
 }
+
+void
+_demangle_topic_data(const std::string & topic_name, TopicData & topic_data)
+{
+  const std::string prefix = _get_ros_prefix_if_exists(topic_name);
+  if (prefix == ros_topic_prefix) {
+    topic_data.kind = TopicKind::Topic;
+    topic_data.ros_name = _demangle_if_ros_topic(topic_name);
+    topic_data.ros_type = _demangle_if_ros_type(topic_data.topic_type);
+    return;
+  }
+  std::string service_name = _demangle_service_from_topic(topic_name);
+  if (service_name.empty()) {
+    topic_data.kind = TopicKind::Other;
+    topic_data.ros_name = topic_name;
+    topic_data.ros_type = _demangle_if_ros_type(topic_data.topic_type);
+    return;
+  }
+  // _demangle_service_from_topic() already checked the suffix is at the end
+  const std::string request_suffix = "Request";
+  const bool is_request = topic_name.length() >= request_suffix.length() &&
+    topic_name.compare(
+    topic_name.length() - request_suffix.length(), request_suffix.length(),
+    request_suffix) == 0;
+  topic_data.kind = is_request ? TopicKind::Request : TopicKind::Reply;
+  topic_data.ros_name = std::move(service_name);
+  topic_data.ros_type = _demangle_service_type_only(topic_data.topic_type);
+}
@@ -0,0 +1,57 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+
+#include "rcutils/get_env.h"
+#include "rcutils/logging_macros.h"
+
+#include "rmw_fastrtps_shared_cpp/env.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+bool
+get_env_uint(
+  const char * env_var, uint64_t max_value, const char * fallback, uint64_t & value)
+{
+  const char * env_val = nullptr;
+  const char * error = rcutils_get_env(env_var, &env_val);
+  if (error) {
+    RCUTILS_LOG_WARN_NAMED(
+      "rmw_fastrtps_shared_cpp", "unable to read %s: %s, %s", env_var, error, fallback);
+    return false;
+  }
+  if (env_val[0] == '\0') {
+    return false;
+  }
+  // strtoull skips leading whitespace and takes a sign, wrapping negative values around
+  const bool starts_with_digit = env_val[0] >= '0' && env_val[0] <= '9';
+  char * end = nullptr;
+  errno = 0;
+  unsigned long long parsed = strtoull(env_val, &end, 10);  // NOLINT(runtime/int)
+  if (!starts_with_digit || *end != '\0' || errno == ERANGE || parsed > max_value) {
+    RCUTILS_LOG_WARN_NAMED(
+      "rmw_fastrtps_shared_cpp", "ignoring invalid value '%s' of %s, %s",
+      env_val, env_var, fallback);
+    return false;
+  }
+  value = static_cast<uint64_t>(parsed);
+  return true;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
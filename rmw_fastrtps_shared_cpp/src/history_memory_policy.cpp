@@ -0,0 +1,64 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "rcutils/logging_macros.h"
+
+#include "rmw_fastrtps_shared_cpp/history_memory_policy.hpp"
+#include "rmw_fastrtps_shared_cpp/topic_config.hpp"
+
+using eprosima::fastrtps::rtps::MemoryManagementPolicy_t;
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+bool
+parse_history_memory_policy(const std::string & name, MemoryManagementPolicy_t & policy)
+{
+  if (name == "PREALLOCATED") {
+    policy = eprosima::fastrtps::rtps::PREALLOCATED_MEMORY_MODE;
+  } else if (name == "PREALLOCATED_WITH_REALLOC") {
+    policy = eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+  } else if (name == "DYNAMIC") {
+    policy = eprosima::fastrtps::rtps::DYNAMIC_RESERVE_MEMORY_MODE;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+MemoryManagementPolicy_t
+get_history_memory_policy(const char * topic_name, bool is_bounded, uint32_t type_size)
+{
+  const char * env_var = "RMW_FASTRTPS_HISTORY_MEMORY_POLICY";
+  std::string name = get_topic_config(env_var, topic_name);
+  MemoryManagementPolicy_t policy;
+  if (!name.empty()) {
+    if (parse_history_memory_policy(name, policy)) {
+      return policy;
+    }
+    RCUTILS_LOG_WARN_NAMED(
+      "rmw_fastrtps_shared_cpp",
+      "ignoring invalid history memory policy '%s' of %s for topic '%s'",
+      name.c_str(), env_var, topic_name);
+  }
+
+  if (is_bounded && type_size <= max_preallocated_type_size) {
+    return eprosima::fastrtps::rtps::PREALLOCATED_MEMORY_MODE;
+  }
+  return eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
@@ -0,0 +1,91 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+
+#include "rmw_fastrtps_shared_cpp/env.hpp"
+#include "rmw_fastrtps_shared_cpp/payload_sizing.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+PayloadSizing::PayloadSizing(uint32_t initial_size, uint32_t window)
+: initial_size_(initial_size),
+  window_(window)
+{
+}
+
+uint32_t
+PayloadSizing::reserve(uint32_t size)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  window_max_ = std::max(window_max_, size);
+  if (++window_samples_ == window_) {
+    previous_window_max_ = window_max_;
+    window_max_ = 0;
+    window_samples_ = 0;
+  }
+  last_size_ = size;
+  last_reserved_ = std::max({size, window_max_, previous_window_max_});
+  stats_.reserved_size = last_reserved_;
+  return last_reserved_;
+}
+
+void
+PayloadSizing::on_reserved(const eprosima::fastrtps::rtps::SerializedPayload_t & payload)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++stats_.samples;
+  auto inserted = payloads_.emplace(&payload, PayloadCapacity{initial_size_, initial_size_});
+  PayloadCapacity & capacity = inserted.first->second;
+  if (inserted.second) {
+    // Only reallocated payloads get exactly the reserved size
+    if (payload.max_size == last_reserved_ && last_reserved_ > initial_size_) {
+      ++stats_.reallocations;
+    }
+  } else if (payload.max_size != capacity.actual) {
+    ++stats_.reallocations;
+  }
+  capacity.actual = payload.max_size;
+  if (last_size_ > capacity.exact) {
+    ++stats_.reallocations_without_presizing;
+    capacity.exact = last_size_;
+  }
+}
+
+PayloadSizingStats
+PayloadSizing::stats() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+static uint32_t read_payload_sizing_window()
+{
+  uint64_t window = 64;
+  get_env_uint(
+    "RMW_FASTRTPS_PAYLOAD_SIZING_WINDOW", UINT32_MAX, "using a window of 64 samples", window);
+  return static_cast<uint32_t>(window);
+}
+
+uint32_t
+get_payload_sizing_window()
+{
+  static const uint32_t window = read_payload_sizing_window();
+  return window;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
@@ -0,0 +1,58 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "rcutils/logging_macros.h"
+
+#include "rmw_fastrtps_shared_cpp/publish_mode.hpp"
+#include "rmw_fastrtps_shared_cpp/topic_config.hpp"
+
+using eprosima::fastrtps::PublishModeQosPolicyKind;
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+bool
+parse_publish_mode(const std::string & name, PublishModeQosPolicyKind & kind)
+{
+  if (name == "SYNCHRONOUS") {
+    kind = eprosima::fastrtps::SYNCHRONOUS_PUBLISH_MODE;
+  } else if (name == "ASYNCHRONOUS") {
+    kind = eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+PublishModeQosPolicyKind
+get_publish_mode(const char * name)
+{
+  const char * env_var = "RMW_FASTRTPS_PUBLISH_MODE";
+  std::string mode = get_topic_config(env_var, name);
+  PublishModeQosPolicyKind kind;
+  if (!mode.empty()) {
+    if (parse_publish_mode(mode, kind)) {
+      return kind;
+    }
+    RCUTILS_LOG_WARN_NAMED(
+      "rmw_fastrtps_shared_cpp",
+      "ignoring invalid publish mode '%s' of %s for '%s'",
+      mode.c_str(), env_var, name);
+  }
+  return eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
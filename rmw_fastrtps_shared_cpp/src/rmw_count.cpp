@@ -15,7 +15,6 @@
 #include <map>
 #include <string>
 #include <vector>
-#include <mutex>
 #include <numeric>
 
 #include "rcutils/logging_macros.h"
@@ -69,12 +68,12 @@ __rmw_count_publishers(
   *count = 0;
   ::ParticipantListener * slave_target = impl->listener;
   {
-    std::lock_guard<std::mutex> guard(slave_target->writer_topic_cache.getMutex());
+    auto topic_cache = slave_target->writer_topic_cache.getSnapshot();
     // Search and sum up the publisher counts
-    auto & topic_types = slave_target->writer_topic_cache().getTopicToTypes();
+    const auto & topic_data = topic_cache->getTopicNameToTopicData();
     for (const auto & topic_fqdn : topic_fqdns) {
-      const auto & it = topic_types.find(topic_fqdn);
-      if (it != topic_types.end()) {
+      const auto & it = topic_data.find(topic_fqdn);
+      if (it != topic_data.end()) {
         *count += it->second.size();
       }
     }
@@ -125,12 +124,12 @@ __rmw_count_subscribers(
   *count = 0;
   ::ParticipantListener * slave_target = impl->listener;
   {
-    std::lock_guard<std::mutex> guard(slave_target->reader_topic_cache.getMutex());
+    auto topic_cache = slave_target->reader_topic_cache.getSnapshot();
     // Search and sum up the subscriber counts
-    auto & topic_types = slave_target->reader_topic_cache().getTopicToTypes();
+    const auto & topic_data = topic_cache->getTopicNameToTopicData();
     for (const auto & topic_fqdn : topic_fqdns) {
-      const auto & it = topic_types.find(topic_fqdn);
-      if (it != topic_types.end()) {
+      const auto & it = topic_data.find(topic_fqdn);
+      if (it != topic_data.end()) {
         *count += it->second.size();
       }
     }
@@ -162,8 +162,13 @@ _set_rmw_topic_endpoint_info(
     return ret;
   }
   // set topic type
-  std::string type_name =
-    no_mangle ? topic_data.topic_type : _demangle_if_ros_type(topic_data.topic_type);
+  // ros_type holds the service type for requests and replies, demangle those as messages
+  std::string type_name = topic_data.topic_type;
+  if (!no_mangle) {
+    const bool is_service =
+      topic_data.kind == TopicKind::Request || topic_data.kind == TopicKind::Reply;
+    type_name = is_service ? _demangle_if_ros_type(type_name) : topic_data.ros_type;
+  }
   ret = rmw_topic_endpoint_info_set_topic_type(topic_endpoint_info, type_name.c_str(), allocator);
   if (ret != RMW_RET_OK) {
     return ret;
@@ -235,16 +240,16 @@ _get_info_by_topic(
 
   const auto & topic_fqdns = _get_topic_fqdns(topic_name, no_mangle);
   auto impl = static_cast<CustomParticipantInfo *>(node->data);
-  // The GUID of the participant associated with this node
-  const auto & participant_guid = impl->participant->getGuid();
+  // The GUID identifying this node in the topic cache
+  const auto & participant_guid = impl->node_guid;
   const auto & node_name = node->name;
   const auto & node_namespace = node->namespace_;
   ::ParticipantListener * slave_target = impl->listener;
-  auto & topic_cache =
-    is_publisher ? slave_target->writer_topic_cache : slave_target->reader_topic_cache;
+  auto topic_cache = is_publisher ?
+    slave_target->writer_topic_cache.getSnapshot() :
+    slave_target->reader_topic_cache.getSnapshot();
   {
-    std::lock_guard<std::mutex> guard(topic_cache.getMutex());
-    const auto & topic_name_to_data = topic_cache().getTopicNameToTopicData();
+    const auto & topic_name_to_data = topic_cache->getTopicNameToTopicData();
     std::vector<rmw_topic_endpoint_info_t> topic_endpoint_info_vector;
     for (const auto & topic_name : topic_fqdns) {
       const auto it = topic_name_to_data.find(topic_name);
@@ -13,6 +13,10 @@
 // limitations under the License.
 
 #include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
 #include <utility>
 #include <set>
 #include <string>
@@ -47,7 +51,9 @@
 #include "fastrtps/rtps/builtin/discovery/endpoint/EDPSimple.h"
 
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/env.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_shared_cpp/rmw_context_impl.hpp"
 
 using Domain = eprosima::fastrtps::Domain;
 using IPLocator = eprosima::fastrtps::rtps::IPLocator;
@@ -58,128 +64,6 @@ using StatefulReader = eprosima::fastrtps::rtps::StatefulReader;
 
 namespace rmw_fastrtps_shared_cpp
 {
-rmw_node_t *
-create_node(
-  const char * identifier,
-  const char * name,
-  const char * namespace_,
-  ParticipantAttributes participantAttrs)
-{
-  if (!name) {
-    RMW_SET_ERROR_MSG("name is null");
-    return nullptr;
-  }
-
-  if (!namespace_) {
-    RMW_SET_ERROR_MSG("namespace_ is null");
-    return nullptr;
-  }
-
-  // Declare everything before beginning to create things.
-  ::ParticipantListener * listener = nullptr;
-  Participant * participant = nullptr;
-  rmw_guard_condition_t * graph_guard_condition = nullptr;
-  CustomParticipantInfo * node_impl = nullptr;
-  rmw_node_t * node_handle = nullptr;
-
-  graph_guard_condition = __rmw_create_guard_condition(identifier);
-  if (!graph_guard_condition) {
-    // error already set
-    goto fail;
-  }
-
-  try {
-    listener = new ::ParticipantListener(graph_guard_condition);
-  } catch (std::bad_alloc &) {
-    RMW_SET_ERROR_MSG("failed to allocate participant listener");
-    goto fail;
-  }
-
-  participant = Domain::createParticipant(participantAttrs, listener);
-  if (!participant) {
-    RMW_SET_ERROR_MSG("create_node() could not create participant");
-    return nullptr;
-  }
-
-  try {
-    node_impl = new CustomParticipantInfo();
-
-    node_impl->leave_middleware_default_qos = false;
-    const char * env_var = "RMW_FASTRTPS_USE_QOS_FROM_XML";
-    // Check if the configuration from XML has been enabled from
-    // the RMW_FASTRTPS_USE_QOS_FROM_XML env variable.
-    char * config_env_val = nullptr;
-#ifndef _WIN32
-    config_env_val = getenv(env_var);
-    if (config_env_val != nullptr) {
-      node_impl->leave_middleware_default_qos = strcmp(config_env_val, "1") == 0;
-    }
-#else
-    size_t config_env_val_size;
-    _dupenv_s(&config_env_val, &config_env_val_size, env_var);
-    if (config_env_val != nullptr) {
-      node_impl->leave_middleware_default_qos = strcmp(config_env_val, "1") == 0;
-    }
-    free(config_env_val);
-#endif
-  } catch (std::bad_alloc &) {
-    RMW_SET_ERROR_MSG("failed to allocate node impl struct");
-    goto fail;
-  }
-
-  node_handle = rmw_node_allocate();
-  if (!node_handle) {
-    RMW_SET_ERROR_MSG("failed to allocate rmw_node_t");
-    goto fail;
-  }
-  node_handle->implementation_identifier = identifier;
-  node_impl->participant = participant;
-  node_impl->listener = listener;
-  node_impl->graph_guard_condition = graph_guard_condition;
-  node_handle->data = node_impl;
-
-  node_handle->name =
-    static_cast<const char *>(rmw_allocate(sizeof(char) * strlen(name) + 1));
-  if (!node_handle->name) {
-    RMW_SET_ERROR_MSG("failed to allocate memory");
-    node_handle->namespace_ = nullptr;  // to avoid free on uninitialized memory
-    goto fail;
-  }
-  memcpy(const_cast<char *>(node_handle->name), name, strlen(name) + 1);
-
-  node_handle->namespace_ =
-    static_cast<const char *>(rmw_allocate(sizeof(char) * strlen(namespace_) + 1));
-  if (!node_handle->namespace_) {
-    RMW_SET_ERROR_MSG("failed to allocate memory");
-    goto fail;
-  }
-  memcpy(const_cast<char *>(node_handle->namespace_), namespace_, strlen(namespace_) + 1);
-
-  return node_handle;
-fail:
-  if (node_handle) {
-    rmw_free(const_cast<char *>(node_handle->namespace_));
-    node_handle->namespace_ = nullptr;
-    rmw_free(const_cast<char *>(node_handle->name));
-    node_handle->name = nullptr;
-  }
-  rmw_node_free(node_handle);
-  delete node_impl;
-  if (graph_guard_condition) {
-    rmw_ret_t ret = __rmw_destroy_guard_condition(graph_guard_condition);
-    if (ret != RMW_RET_OK) {
-      RCUTILS_LOG_ERROR_NAMED(
-        "rmw_fastrtps_shared_cpp",
-        "failed to destroy guard condition during error handling");
-    }
-  }
-  rmw_free(listener);
-  if (participant) {
-    Domain::removeParticipant(participant);
-  }
-  return nullptr;
-}
-
 bool
 get_security_file_paths(
   std::array<std::string, 6> & security_files_paths, const char * node_secure_root)
@@ -214,24 +98,26 @@ get_security_file_paths(
   return true;
 }
 
-rmw_node_t *
-__rmw_create_node(
-  const char * identifier,
+/**
+ * Create the participant shared by all the nodes of a context with the same settings.
+ *
+ * \param name of the node triggering the creation, used to name the participant
+ * \param namespace_ of the node triggering the creation
+ * \param domain_id of the participant
+ * \param security_options of the participant
+ * \param localhost_only whether the participant only uses the loopback interface
+ * \param shared_participant [out] the created participant and listener
+ * \return true if successful
+ */
+static bool
+create_shared_participant(
   const char * name,
   const char * namespace_,
   size_t domain_id,
   const rmw_node_security_options_t * security_options,
-  bool localhost_only)
+  bool localhost_only,
+  SharedParticipantInfo & shared_participant)
 {
-  if (!name) {
-    RMW_SET_ERROR_MSG("name is null");
-    return nullptr;
-  }
-  if (!security_options) {
-    RMW_SET_ERROR_MSG("security_options is null");
-    return nullptr;
-  }
-
   ParticipantAttributes participantAttrs;
 
   // Load default XML profile.
@@ -278,15 +164,18 @@ __rmw_create_node(
       eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
   }
 
+  // The first node is still advertised in the participant user data, so peers which
+  // do not know about shared participants see a single node process as before.
   size_t length = strlen(name) + strlen("name=;") +
-    strlen(namespace_) + strlen("namespace=;") + 1;
+    strlen(namespace_) + strlen("namespace=;") +
+    strlen(kSharedParticipantUserDataKey) + strlen("=true;") + 1;
   participantAttrs.rtps.userData.resize(length);
   int written = snprintf(
     reinterpret_cast<char *>(participantAttrs.rtps.userData.data()),
-    length, "name=%s;namespace=%s;", name, namespace_);
+    length, "name=%s;namespace=%s;%s=true;", name, namespace_, kSharedParticipantUserDataKey);
   if (written < 0 || written > static_cast<int>(length) - 1) {
     RMW_SET_ERROR_MSG("failed to populate user_data buffer");
-    return nullptr;
+    return false;
   }
 
   if (security_options->security_root_path) {
@@ -330,16 +219,176 @@ __rmw_create_node(
       participantAttrs.rtps.properties = property_policy;
     } else if (security_options->enforce_security) {
       RMW_SET_ERROR_MSG("couldn't find all security files!");
-      return nullptr;
+      return false;
     }
 #else
     RMW_SET_ERROR_MSG(
       "This Fast-RTPS version doesn't have the security libraries\n"
       "Please compile Fast-RTPS using the -DSECURITY=ON CMake option");
-    return nullptr;
+    return false;
 #endif
   }
-  return create_node(identifier, name, namespace_, participantAttrs);
+
+  // Check if graph change notifications should be coalesced, from the
+  // RMW_FASTRTPS_GRAPH_NOTIFICATION_PERIOD env variable (in milliseconds).
+  uint64_t period = 0;
+  rmw_fastrtps_shared_cpp::get_env_uint(
+    "RMW_FASTRTPS_GRAPH_NOTIFICATION_PERIOD", UINT32_MAX,
+    "graph changes are not coalesced", period);
+  std::chrono::milliseconds graph_notification_period(period);
+
+  ::ParticipantListener * listener =
+    new (std::nothrow) ::ParticipantListener(graph_notification_period);
+  if (!listener) {
+    RMW_SET_ERROR_MSG("failed to allocate participant listener");
+    return false;
+  }
+
+  Participant * participant = Domain::createParticipant(participantAttrs, listener);
+  if (!participant) {
+    RMW_SET_ERROR_MSG("create_node() could not create participant");
+    delete listener;
+    return false;
+  }
+
+  shared_participant.participant = participant;
+  shared_participant.listener = listener;
+  shared_participant.leave_middleware_default_qos = leave_middleware_default_qos;
+  shared_participant.node_count = 0u;
+  shared_participant.next_node_id = 0u;
+  return true;
+}
+
+rmw_node_t *
+__rmw_create_node(
+  const char * identifier,
+  rmw_context_t * context,
+  const char * name,
+  const char * namespace_,
+  size_t domain_id,
+  const rmw_node_security_options_t * security_options,
+  bool localhost_only)
+{
+  if (!context || !context->impl) {
+    RMW_SET_ERROR_MSG("context is not initialized");
+    return nullptr;
+  }
+  if (!name) {
+    RMW_SET_ERROR_MSG("name is null");
+    return nullptr;
+  }
+  if (!namespace_) {
+    RMW_SET_ERROR_MSG("namespace_ is null");
+    return nullptr;
+  }
+  if (!security_options) {
+    RMW_SET_ERROR_MSG("security_options is null");
+    return nullptr;
+  }
+
+  rmw_context_impl_t * context_impl = context->impl;
+  SharedParticipantKey key(
+    domain_id,
+    localhost_only,
+    security_options->security_root_path ? security_options->security_root_path : "",
+    security_options->enforce_security == RMW_SECURITY_ENFORCEMENT_ENFORCE);
+
+  std::lock_guard<std::mutex> guard(context_impl->mutex);
+
+  auto shared_it = context_impl->participants.find(key);
+  if (shared_it == context_impl->participants.end()) {
+    SharedParticipantInfo shared_participant;
+    if (!create_shared_participant(
+        name, namespace_, domain_id, security_options, localhost_only, shared_participant))
+    {
+      // error already set
+      return nullptr;
+    }
+    shared_it = context_impl->participants.emplace(key, shared_participant).first;
+  }
+  SharedParticipantInfo & shared_participant = shared_it->second;
+
+  // Declare everything before beginning to create things.
+  rmw_guard_condition_t * graph_guard_condition = nullptr;
+  CustomParticipantInfo * node_impl = nullptr;
+  rmw_node_t * node_handle = nullptr;
+  uint32_t node_id = shared_participant.next_node_id++;
+
+  graph_guard_condition = __rmw_create_guard_condition(identifier);
+  if (!graph_guard_condition) {
+    // error already set
+    goto fail;
+  }
+
+  try {
+    node_impl = new CustomParticipantInfo();
+    node_impl->participant = shared_participant.participant;
+    node_impl->listener = shared_participant.listener;
+    node_impl->graph_guard_condition = graph_guard_condition;
+    node_impl->node_guid =
+      create_node_guid(shared_participant.participant->getGuid().guidPrefix, node_id);
+    node_impl->endpoint_user_data = create_node_user_data(name, namespace_, node_id);
+    node_impl->context = context_impl;
+    node_impl->participant_key = key;
+    node_impl->leave_middleware_default_qos = shared_participant.leave_middleware_default_qos;
+  } catch (std::bad_alloc &) {
+    RMW_SET_ERROR_MSG("failed to allocate node impl struct");
+    goto fail;
+  }
+
+  node_handle = rmw_node_allocate();
+  if (!node_handle) {
+    RMW_SET_ERROR_MSG("failed to allocate rmw_node_t");
+    goto fail;
+  }
+  node_handle->implementation_identifier = identifier;
+  node_handle->data = node_impl;
+
+  node_handle->name =
+    static_cast<const char *>(rmw_allocate(sizeof(char) * strlen(name) + 1));
+  if (!node_handle->name) {
+    RMW_SET_ERROR_MSG("failed to allocate memory");
+    node_handle->namespace_ = nullptr;  // to avoid free on uninitialized memory
+    goto fail;
+  }
+  memcpy(const_cast<char *>(node_handle->name), name, strlen(name) + 1);
+
+  node_handle->namespace_ =
+    static_cast<const char *>(rmw_allocate(sizeof(char) * strlen(namespace_) + 1));
+  if (!node_handle->namespace_) {
+    RMW_SET_ERROR_MSG("failed to allocate memory");
+    goto fail;
+  }
+  memcpy(const_cast<char *>(node_handle->namespace_), namespace_, strlen(namespace_) + 1);
+
+  ++shared_participant.node_count;
+  shared_participant.listener->attach_graph_guard_condition(graph_guard_condition);
+  shared_participant.listener->add_local_node(node_impl->node_guid, name, namespace_);
+
+  return node_handle;
+fail:
+  if (node_handle) {
+    rmw_free(const_cast<char *>(node_handle->namespace_));
+    node_handle->namespace_ = nullptr;
+    rmw_free(const_cast<char *>(node_handle->name));
+    node_handle->name = nullptr;
+  }
+  rmw_node_free(node_handle);
+  delete node_impl;
+  if (graph_guard_condition) {
+    rmw_ret_t ret = __rmw_destroy_guard_condition(graph_guard_condition);
+    if (ret != RMW_RET_OK) {
+      RCUTILS_LOG_ERROR_NAMED(
+        "rmw_fastrtps_shared_cpp",
+        "failed to destroy guard condition during error handling");
+    }
+  }
+  if (0u == shared_participant.node_count) {
+    Domain::removeParticipant(shared_participant.participant);
+    delete shared_participant.listener;
+    context_impl->participants.erase(shared_it);
+  }
+  return nullptr;
 }
 
 rmw_ret_t
@@ -364,7 +413,8 @@ __rmw_destroy_node(
     return RMW_RET_ERROR;
   }
 
-  Participant * participant = impl->participant;
+  rmw_context_impl_t * context_impl = impl->context;
+  std::lock_guard<std::mutex> guard(context_impl->mutex);
 
   // Begin deleting things in the same order they were created in __rmw_create_node().
   rmw_free(const_cast<char *>(node->name));
@@ -373,15 +423,22 @@ __rmw_destroy_node(
   node->namespace_ = nullptr;
   rmw_node_free(node);
 
-  Domain::removeParticipant(participant);
+  impl->listener->remove_local_node(impl->node_guid);
+  impl->listener->detach_graph_guard_condition(impl->graph_guard_condition);
 
   if (RMW_RET_OK != __rmw_destroy_guard_condition(impl->graph_guard_condition)) {
     RMW_SET_ERROR_MSG("failed to destroy graph guard condition");
     result_ret = RMW_RET_ERROR;
   }
 
-  delete impl->listener;
-  impl->listener = nullptr;
+  // The participant goes away with the last node using it.
+  auto shared_it = context_impl->participants.find(impl->participant_key);
+  if (shared_it != context_impl->participants.end() && 0u == --shared_it->second.node_count) {
+    Domain::removeParticipant(shared_it->second.participant);
+    delete shared_it->second.listener;
+    context_impl->participants.erase(shared_it);
+  }
+
   delete impl;
 
   return result_ret;
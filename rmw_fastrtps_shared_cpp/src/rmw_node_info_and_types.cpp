@@ -32,9 +32,7 @@
 #include "rmw/names_and_types.h"
 #include "rmw/rmw.h"
 
-#include "demangle.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
-#include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 
 #include "rmw_fastrtps_shared_cpp/topic_cache.hpp"
@@ -60,36 +58,14 @@ rmw_ret_t __get_guid_by_name(
 {
   auto impl = static_cast<CustomParticipantInfo *>(node->data);
   if (strcmp(node->name, node_name) == 0 && strcmp(node->namespace_, node_namespace) == 0) {
-    guid = impl->participant->getGuid();
-  } else {
-    std::set<GUID_t> nodes_in_desired_namespace;
-    std::lock_guard<std::mutex> guard(impl->listener->names_mutex_);
-
-    auto namespaces = impl->listener->discovered_namespaces;
-    for (auto & guid_to_namespace : impl->listener->discovered_namespaces) {
-      if (guid_to_namespace.second == node_namespace) {
-        nodes_in_desired_namespace.insert(guid_to_namespace.first);
-      }
-    }
-
-    auto guid_node_pair = std::find_if(
-      impl->listener->discovered_names.begin(),
-      impl->listener->discovered_names.end(),
-      [node_name, &nodes_in_desired_namespace](const std::pair<const GUID_t,
-      std::string> & pair) {
-        return pair.second == node_name &&
-        nodes_in_desired_namespace.find(pair.first) != nodes_in_desired_namespace.end();
-      });
-
-    if (guid_node_pair == impl->listener->discovered_names.end()) {
-      RMW_SET_ERROR_MSG_WITH_FORMAT_STRING(
-        "Node name not found: ns='%s', name='%s'",
-        node_namespace,
-        node_name
-      );
-      return RMW_RET_NODE_NAME_NON_EXISTENT;
-    }
-    guid = guid_node_pair->first;
+    guid = impl->node_guid;
+  } else if (!impl->listener->get_node_guid(node_namespace, node_name, guid)) {
+    RMW_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Node name not found: ns='%s', name='%s'",
+      node_namespace,
+      node_name
+    );
+    return RMW_RET_NODE_NAME_NON_EXISTENT;
   }
   return RMW_RET_OK;
 }
@@ -158,16 +134,21 @@ __accumulate_topics(
   const GUID_t & node_guid_,
   bool no_demangle)
 {
-  std::lock_guard<std::mutex> guard(topic_cache.getMutex());
-  const auto & node_topics = topic_cache().getParticipantToTopics().find(node_guid_);
-  if (node_topics == topic_cache().getParticipantToTopics().end()) {
+  auto snapshot = topic_cache.getSnapshot();
+  const auto & node_topics = snapshot->getParticipantToTopics().find(node_guid_);
+  if (node_topics == snapshot->getParticipantToTopics().end()) {
     RCUTILS_LOG_DEBUG_NAMED(
       kLoggerTag,
       "No topics found for node");
     return;
   }
   for (auto & topic_pair : node_topics->second) {
-    if (!no_demangle && _get_ros_prefix_if_exists(topic_pair.first) != ros_topic_prefix) {
+    if (topic_pair.second.empty()) {
+      continue;
+    }
+    // topic data of the same topic name all share the same kind and ros_name
+    const TopicData & first_topic_data = topic_pair.second.front();
+    if (!no_demangle && first_topic_data.kind != TopicKind::Topic) {
       // if we are demangling and this is not prefixed with rt/, skip it
       continue;
     }
@@ -176,17 +157,18 @@ __accumulate_topics(
       "accumulate_topics: Found topic %s",
       topic_pair.first.c_str());
 
-    topics[topic_pair.first].insert(
-      topic_pair.second.begin(), topic_pair.second.end());
+    auto & types = topics[no_demangle ? topic_pair.first : first_topic_data.ros_name];
+    for (const auto & topic_data : topic_pair.second) {
+      types.insert(no_demangle ? topic_data.topic_type : topic_data.ros_type);
+    }
   }
 }
 
 /**
  * Copy topic data to results
  *
- * \param topics to copy over
+ * \param topics to copy over, already demangled if requested
  * \param allocator to use
- * \param no_demangle true if demangling will not occur
  * \param topic_names_and_types [out] final rmw result
  * \return RMW_RET_OK if successful
  */
@@ -194,7 +176,6 @@ rmw_ret_t
 __copy_data_to_results(
   const std::map<std::string, std::set<std::string>> & topics,
   rcutils_allocator_t * allocator,
-  bool no_demangle,
   rmw_names_and_types_t * topic_names_and_types)
 {
   // Copy data to results handle
@@ -213,21 +194,11 @@ __copy_data_to_results(
             "error during report of error: %s", rmw_get_error_string().str);
         }
       };
-    // Setup demangling functions based on no_demangle option
-    auto demangle_topic = _demangle_if_ros_topic;
-    auto demangle_type = _demangle_if_ros_type;
-    if (no_demangle) {
-      auto noop = [](const std::string & in) {
-          return in;
-        };
-      demangle_topic = noop;
-      demangle_type = noop;
-    }
     // For each topic, store the name, initialize the string array for types, and store all types
     size_t index = 0;
     for (const auto & topic_n_types : topics) {
       // Duplicate and store the topic_name
-      char * topic_name = rcutils_strdup(demangle_topic(topic_n_types.first).c_str(), *allocator);
+      char * topic_name = rcutils_strdup(topic_n_types.first.c_str(), *allocator);
       if (!topic_name) {
         RMW_SET_ERROR_MSG("failed to allocate memory for topic name");
         fail_cleanup();
@@ -249,7 +220,7 @@ __copy_data_to_results(
       // Duplicate and store each type for the topic
       size_t type_index = 0;
       for (const auto & type : topic_n_types.second) {
-        char * type_name = rcutils_strdup(demangle_type(type).c_str(), *allocator);
+        char * type_name = rcutils_strdup(type.c_str(), *allocator);
         if (!type_name) {
           RMW_SET_ERROR_MSG("failed to allocate memory for type name");
           fail_cleanup();
@@ -269,19 +240,17 @@ __log_debug_information(const CustomParticipantInfo & impl)
 {
   if (rcutils_logging_logger_is_enabled_for(kLoggerTag, RCUTILS_LOG_SEVERITY_DEBUG)) {
     {
-      auto & topic_cache = impl.listener->writer_topic_cache;
-      std::lock_guard<std::mutex> guard(topic_cache.getMutex());
+      auto topic_cache = impl.listener->writer_topic_cache.getSnapshot();
       std::stringstream map_ss;
-      map_ss << topic_cache();
+      map_ss << *topic_cache;
       RCUTILS_LOG_DEBUG_NAMED(
         kLoggerTag,
         "Publisher Topic cache is: %s", map_ss.str().c_str());
     }
     {
-      auto & topic_cache = impl.listener->reader_topic_cache;
-      std::lock_guard<std::mutex> guard(topic_cache.getMutex());
+      auto topic_cache = impl.listener->reader_topic_cache.getSnapshot();
       std::stringstream map_ss;
-      map_ss << topic_cache();
+      map_ss << *topic_cache;
       RCUTILS_LOG_DEBUG_NAMED(
         kLoggerTag,
         "Subscriber Topic cache is: %s", map_ss.str().c_str());
@@ -352,7 +321,7 @@ __rmw_get_topic_names_and_types_by_node(
   }
   std::map<std::string, std::set<std::string>> topics;
   __accumulate_topics(retrieve_cache_func(*impl), topics, guid, no_demangle);
-  return __copy_data_to_results(topics, allocator, no_demangle, topic_names_and_types);
+  return __copy_data_to_results(topics, allocator, topic_names_and_types);
 }
 
 rmw_ret_t
@@ -402,9 +371,8 @@ __get_service_names_and_types_by_node(
   const char * node_name,
   const char * node_namespace,
   rmw_names_and_types_t * service_names_and_types,
-  const char * topic_suffix)
+  TopicKind topic_kind)
 {
-  const std::string topic_suffix_stdstr(topic_suffix);
   rmw_ret_t valid_input = __validate_input(
     identifier, node, allocator, node_name, node_namespace, service_names_and_types);
   if (valid_input != RMW_RET_OK) {
@@ -421,29 +389,17 @@ __get_service_names_and_types_by_node(
 
   std::map<std::string, std::set<std::string>> services;
   {
-    auto & topic_cache = impl->listener->reader_topic_cache;
-    std::lock_guard<std::mutex> guard(topic_cache.getMutex());
-    const auto & node_topics = topic_cache().getParticipantToTopics().find(guid);
-    if (node_topics != topic_cache().getParticipantToTopics().end()) {
+    auto topic_cache = impl->listener->reader_topic_cache.getSnapshot();
+    const auto & node_topics = topic_cache->getParticipantToTopics().find(guid);
+    if (node_topics != topic_cache->getParticipantToTopics().end()) {
       for (auto & topic_pair : node_topics->second) {
-        std::string service_name = _demangle_service_from_topic(topic_pair.first);
-        if (service_name.empty()) {
-          // not a service
-          continue;
-        }
-        // Check if the topic suffix matches and is at the end of the name
-        const std::string & topic_name = topic_pair.first;
-        auto suffix_position = topic_name.rfind(topic_suffix_stdstr);
-        if (suffix_position == std::string::npos ||
-          topic_name.length() - suffix_position - topic_suffix_stdstr.length() != 0)
-        {
-          continue;
-        }
-
-        for (auto & itt : topic_pair.second) {
-          std::string service_type = _demangle_service_type_only(itt);
-          if (!service_type.empty()) {
-            services[service_name].insert(service_type);
+        for (auto & topic_data : topic_pair.second) {
+          // Only keep the request or reply topics of services
+          if (topic_data.kind != topic_kind) {
+            continue;
+          }
+          if (!topic_data.ros_type.empty()) {
+            services[topic_data.ros_name].insert(topic_data.ros_type);
           }
         }
       }
@@ -521,7 +477,7 @@ __rmw_get_service_names_and_types_by_node(
     node_name,
     node_namespace,
     service_names_and_types,
-    "Request");
+    TopicKind::Request);
 }
 
 rmw_ret_t
@@ -540,7 +496,7 @@ __rmw_get_client_names_and_types_by_node(
     node_name,
     node_namespace,
     service_names_and_types,
-    "Reply");
+    TopicKind::Reply);
 }
 
 }  // namespace rmw_fastrtps_shared_cpp
@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "rcutils/allocator.h"
 #include "rcutils/logging_macros.h"
@@ -59,8 +61,19 @@ __rmw_get_node_names(
   }
 
   auto impl = static_cast<CustomParticipantInfo *>(node->data);
-  auto participant_names = impl->listener->get_discovered_names();
-  auto participant_ns = impl->listener->get_discovered_namespaces();
+  std::vector<std::string> participant_names;
+  std::vector<std::string> participant_ns;
+  {
+    std::lock_guard<std::mutex> guard(impl->listener->names_mutex_);
+    for (const auto & guid_name_pair : impl->listener->discovered_names) {
+      // this node is reported first, see below
+      if (guid_name_pair.first == impl->node_guid) {
+        continue;
+      }
+      participant_names.push_back(guid_name_pair.second);
+      participant_ns.push_back(impl->listener->discovered_namespaces[guid_name_pair.first]);
+    }
+  }
 
   rcutils_allocator_t allocator = rcutils_get_default_allocator();
   rcutils_ret_t rcutils_ret =
@@ -12,9 +12,6 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include "fastcdr/Cdr.h"
-#include "fastcdr/FastBuffer.h"
-
 #include "rmw/allocators.h"
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
@@ -49,6 +46,7 @@ __rmw_publish(
   data.is_cdr_buffer = false;
   data.data = const_cast<void *>(ros_message);
   data.impl = info->type_support_impl_;
+  data.payload_sizing = info->payload_sizing_.get();
   if (!info->publisher_->write(&data)) {
     RMW_SET_ERROR_MSG("cannot publish data");
     return RMW_RET_ERROR;
@@ -77,19 +75,13 @@ __rmw_publish_serialized_message(
   auto info = static_cast<CustomPublisherInfo *>(publisher->data);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "publisher info pointer is null", return RMW_RET_ERROR);
 
-  eprosima::fastcdr::FastBuffer buffer(
-    reinterpret_cast<char *>(serialized_message->buffer), serialized_message->buffer_length);
-  eprosima::fastcdr::Cdr ser(
-    buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
-  if (!ser.jump(serialized_message->buffer_length)) {
-    RMW_SET_ERROR_MSG("cannot correctly set serialized buffer");
-    return RMW_RET_ERROR;
-  }
-
   rmw_fastrtps_shared_cpp::SerializedData data;
   data.is_cdr_buffer = true;
-  data.data = &ser;
+  data.data = nullptr;
   data.impl = nullptr;    // not used when is_cdr_buffer is true
+  // Copied as is into the payload, it is only read
+  data.serialized_message = const_cast<rmw_serialized_message_t *>(serialized_message);
+  data.payload_sizing = info->payload_sizing_.get();
   if (!info->publisher_->write(&data)) {
     RMW_SET_ERROR_MSG("cannot publish data");
     return RMW_RET_ERROR;
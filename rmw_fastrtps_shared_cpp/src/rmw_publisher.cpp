@@ -148,4 +148,31 @@ __rmw_publisher_get_actual_qos(
 
   return RMW_RET_OK;
 }
+
+rmw_ret_t
+__rmw_publisher_get_payload_sizing_stats(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  PayloadSizingStats & stats)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(publisher, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    publisher,
+    publisher->implementation_identifier,
+    identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+
+  auto info = static_cast<CustomPublisherInfo *>(publisher->data);
+  if (nullptr == info) {
+    RMW_SET_ERROR_MSG("publisher internal data is invalid");
+    return RMW_RET_ERROR;
+  }
+
+  if (info->payload_sizing_) {
+    stats = info->payload_sizing_->stats();
+  } else {
+    stats = PayloadSizingStats{0, 0, 0, 0};
+  }
+  return RMW_RET_OK;
+}
 }  // namespace rmw_fastrtps_shared_cpp
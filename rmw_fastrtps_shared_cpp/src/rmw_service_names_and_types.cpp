@@ -26,7 +26,6 @@
 #include "rmw/names_and_types.h"
 #include "rmw/rmw.h"
 
-#include "demangle.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 
@@ -69,17 +68,15 @@ __rmw_get_service_names_and_types(
 
   // Setup processing function, will be used with two maps
   auto map_process = [&services](const LockedObject<TopicCache> & topic_cache) {
-      std::lock_guard<std::mutex> guard(topic_cache.getMutex());
-      for (auto it : topic_cache().getTopicToTypes()) {
-        std::string service_name = _demangle_service_from_topic(it.first);
-        if (service_name.empty()) {
-          // not a service
-          continue;
-        }
-        for (auto & itt : it.second) {
-          std::string service_type = _demangle_service_type_only(itt);
-          if (!service_type.empty()) {
-            services[service_name].insert(service_type);
+      auto snapshot = topic_cache.getSnapshot();
+      for (const auto & it : snapshot->getTopicNameToTopicData()) {
+        for (const auto & topic_data : it.second) {
+          if (topic_data.kind != TopicKind::Request && topic_data.kind != TopicKind::Reply) {
+            // not a service
+            continue;
+          }
+          if (!topic_data.ros_type.empty()) {
+            services[topic_data.ros_name].insert(topic_data.ros_type);
           }
         }
       }
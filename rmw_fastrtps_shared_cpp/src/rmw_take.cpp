@@ -21,9 +21,6 @@
 #include "fastrtps/subscriber/SampleInfo.h"
 #include "fastrtps/attributes/SubscriberAttributes.h"
 
-#include "fastcdr/Cdr.h"
-#include "fastcdr/FastBuffer.h"
-
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
 #include "rmw_fastrtps_shared_cpp/guid_utils.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
@@ -171,27 +168,18 @@ _take_serialized_message(
   CustomSubscriberInfo * info = static_cast<CustomSubscriberInfo *>(subscription->data);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
 
-  eprosima::fastcdr::FastBuffer buffer;
   eprosima::fastrtps::SampleInfo_t sinfo;
 
+  // The payload is copied straight into the serialized message
   rmw_fastrtps_shared_cpp::SerializedData data;
   data.is_cdr_buffer = true;
-  data.data = &buffer;
+  data.data = nullptr;
   data.impl = nullptr;    // not used when is_cdr_buffer is true
+  data.serialized_message = serialized_message;
   if (info->subscriber_->takeNextData(&data, &sinfo)) {
     info->listener_->data_taken(info->subscriber_);
 
     if (eprosima::fastrtps::rtps::ALIVE == sinfo.sampleKind) {
-      auto buffer_size = static_cast<size_t>(buffer.getBufferSize());
-      if (serialized_message->buffer_capacity < buffer_size) {
-        auto ret = rmw_serialized_message_resize(serialized_message, buffer_size);
-        if (ret != RMW_RET_OK) {
-          return ret;  // Error message already set
-        }
-      }
-      serialized_message->buffer_length = buffer_size;
-      memcpy(serialized_message->buffer, buffer.getBuffer(), serialized_message->buffer_length);
-
       if (message_info) {
         _assign_message_info(identifier, message_info, &sinfo);
       }
@@ -240,4 +228,47 @@ __rmw_take_serialized_message_with_info(
   return _take_serialized_message(
     identifier, subscription, serialized_message, taken, message_info, allocation);
 }
+
+rmw_ret_t
+__rmw_take_payload(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  eprosima::fastrtps::rtps::SerializedPayload_t * payload,
+  bool * taken,
+  rmw_message_info_t * message_info)
+{
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    subscription, "subscription pointer is null", return RMW_RET_ERROR);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(payload, "payload pointer is null", return RMW_RET_ERROR);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(taken, "boolean flag for taken is null", return RMW_RET_ERROR);
+  *taken = false;
+
+  if (subscription->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("publisher handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  CustomSubscriberInfo * info = static_cast<CustomSubscriberInfo *>(subscription->data);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
+
+  eprosima::fastrtps::SampleInfo_t sinfo;
+
+  rmw_fastrtps_shared_cpp::SerializedData data;
+  data.is_cdr_buffer = false;
+  data.data = nullptr;
+  data.impl = nullptr;    // not used when retaining the payload
+  data.retained_payload = payload;
+  if (info->subscriber_->takeNextData(&data, &sinfo)) {
+    info->listener_->data_taken(info->subscriber_);
+
+    if (eprosima::fastrtps::rtps::ALIVE == sinfo.sampleKind) {
+      if (message_info) {
+        _assign_message_info(identifier, message_info, &sinfo);
+      }
+      *taken = true;
+    }
+  }
+
+  return RMW_RET_OK;
+}
 }  // namespace rmw_fastrtps_shared_cpp
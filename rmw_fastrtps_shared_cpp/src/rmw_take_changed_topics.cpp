@@ -0,0 +1,62 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+
+#include "demangle.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+rmw_ret_t
+__rmw_take_changed_topics(
+  const char * identifier,
+  const rmw_node_t * node,
+  std::vector<std::string> & topic_names)
+{
+  if (!node) {
+    RMW_SET_ERROR_MSG("null node handle");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  if (node->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("node handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  auto impl = static_cast<CustomParticipantInfo *>(node->data);
+  std::set<std::string> changed_topics =
+    impl->listener->take_changed_topics(impl->graph_guard_condition);
+
+  // Demangle only the names which are taken, several changes on a topic are reported once
+  std::set<std::string> names;
+  for (const auto & topic_name : changed_topics) {
+    const std::string prefix = _get_ros_prefix_if_exists(topic_name);
+    if (prefix == ros_topic_prefix) {
+      names.insert(_demangle_if_ros_topic(topic_name));
+      continue;
+    }
+    std::string service_name = _demangle_service_from_topic(topic_name);
+    names.insert(service_name.empty() ? topic_name : service_name);
+  }
+  topic_names.assign(names.begin(), names.end());
+  return RMW_RET_OK;
+}
+}  // namespace rmw_fastrtps_shared_cpp
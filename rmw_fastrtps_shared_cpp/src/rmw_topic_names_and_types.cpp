@@ -12,11 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
-
-#include <functional>
+#include <utility>
 #include <vector>
 
 #include "rcutils/allocator.h"
@@ -33,9 +35,7 @@
 #include "rmw/names_and_types.h"
 #include "rmw/rmw.h"
 
-#include "demangle.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
-#include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 
 #include "rmw_fastrtps_shared_cpp/topic_cache.hpp"
@@ -72,29 +72,49 @@ __rmw_get_topic_names_and_types(
 
   auto impl = static_cast<CustomParticipantInfo *>(node->data);
 
-  // Access the slave Listeners, which are the ones that have the topicnamesandtypes member
-  // Get info from publisher and subscriber
-  // Combined results from the two lists
-  std::map<std::string, std::set<std::string>> topics;
+  ::ParticipantListener * slave_target = impl->listener;
 
-  // Setup processing function, will be used with two maps
-  auto map_process =
-    [&topics, no_demangle](const LockedObject<TopicCache> & topic_cache) {
-      std::lock_guard<std::mutex> guard(topic_cache.getMutex());
-      for (auto it : topic_cache().getTopicToTypes()) {
-        if (!no_demangle && _get_ros_prefix_if_exists(it.first) != ros_topic_prefix) {
-          // if we are demangling and this is not prefixed with rt/, skip it
-          continue;
-        }
-        for (auto & itt : it.second) {
-          topics[it.first].insert(itt);
+  // The result only changes with the graph, reuse it while the graph version is the same.
+  // The version is read before the caches so a concurrent change can only make the
+  // cached result look older than it is, never newer.
+  const uint64_t graph_version = slave_target->get_graph_version();
+  auto cached_topics = slave_target->get_cached_topic_names_and_types(graph_version, no_demangle);
+  if (!cached_topics) {
+    // Access the slave Listeners, which are the ones that have the topicnamesandtypes member
+    // Get info from publisher and subscriber
+    // Combined results from the two lists
+    auto new_topics = std::make_shared<ParticipantListener::TopicNamesAndTypes>();
+
+    // Setup processing function, will be used with two maps
+    auto map_process =
+      [&new_topics, no_demangle](const LockedObject<TopicCache> & topic_cache) {
+        auto snapshot = topic_cache.getSnapshot();
+        for (const auto & it : snapshot->getTopicNameToTopicData()) {
+          if (no_demangle) {
+            for (const auto & topic_data : it.second) {
+              (*new_topics)[it.first].insert(topic_data.topic_type);
+            }
+            continue;
+          }
+          // topic data of the same topic name all share the same kind and ros_name
+          if (it.second.empty() || it.second.front().kind != TopicKind::Topic) {
+            // if we are demangling and this is not prefixed with rt/, skip it
+            continue;
+          }
+          auto & types = (*new_topics)[it.second.front().ros_name];
+          for (const auto & topic_data : it.second) {
+            types.insert(topic_data.ros_type);
+          }
         }
-      }
-    };
+      };
 
-  ::ParticipantListener * slave_target = impl->listener;
-  map_process(slave_target->reader_topic_cache);
-  map_process(slave_target->writer_topic_cache);
+    map_process(slave_target->reader_topic_cache);
+    map_process(slave_target->writer_topic_cache);
+
+    slave_target->cache_topic_names_and_types(graph_version, no_demangle, new_topics);
+    cached_topics = std::move(new_topics);
+  }
+  const auto & topics = *cached_topics;
 
   // Copy data to results handle
   if (!topics.empty()) {
@@ -112,21 +132,11 @@ __rmw_get_topic_names_and_types(
             "error during report of error: %s", rmw_get_error_string().str);
         }
       };
-    // Setup demangling functions based on no_demangle option
-    auto demangle_topic = _demangle_if_ros_topic;
-    auto demangle_type = _demangle_if_ros_type;
-    if (no_demangle) {
-      auto noop = [](const std::string & in) {
-          return in;
-        };
-      demangle_topic = noop;
-      demangle_type = noop;
-    }
     // For each topic, store the name, initialize the string array for types, and store all types
     size_t index = 0;
     for (const auto & topic_n_types : topics) {
       // Duplicate and store the topic_name
-      char * topic_name = rcutils_strdup(demangle_topic(topic_n_types.first).c_str(), *allocator);
+      char * topic_name = rcutils_strdup(topic_n_types.first.c_str(), *allocator);
       if (!topic_name) {
         RMW_SET_ERROR_MSG("failed to allocate memory for topic name");
         fail_cleanup();
@@ -148,7 +158,7 @@ __rmw_get_topic_names_and_types(
       // Duplicate and store each type for the topic
       size_t type_index = 0;
       for (const auto & type : topic_n_types.second) {
-        char * type_name = rcutils_strdup(demangle_type(type).c_str(), *allocator);
+        char * type_name = rcutils_strdup(type.c_str(), *allocator);
         if (!type_name) {
           RMW_SET_ERROR_MSG("failed to allocate memory for type name");
           fail_cleanup();
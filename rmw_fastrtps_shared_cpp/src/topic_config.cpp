@@ -0,0 +1,60 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "rcutils/get_env.h"
+
+#include "rmw_fastrtps_shared_cpp/topic_config.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+static bool pattern_matches(const std::string & pattern, const std::string & topic_name)
+{
+  if (!pattern.empty() && pattern.back() == '*') {
+    return topic_name.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0;
+  }
+  return pattern == topic_name;
+}
+
+std::string
+match_topic_config(const std::string & config, const std::string & topic_name)
+{
+  size_t begin = 0;
+  while (begin < config.size()) {
+    size_t end = config.find(',', begin);
+    if (end == std::string::npos) {
+      end = config.size();
+    }
+    size_t equal = config.find('=', begin);
+    if (equal < end && pattern_matches(config.substr(begin, equal - begin), topic_name)) {
+      return config.substr(equal + 1, end - equal - 1);
+    }
+    begin = end + 1;
+  }
+  return "";
+}
+
+std::string
+get_topic_config(const char * env_var, const std::string & topic_name)
+{
+  const char * env_val = nullptr;
+  if (rcutils_get_env(env_var, &env_val)) {
+    return "";
+  }
+  return match_topic_config(env_val, topic_name);
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
@@ -0,0 +1,96 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares deserializing a big endian float64 array with Fast CDR, which swaps one element at
+// a time, against copying it and swapping it in bulk:
+//   benchmark_byte_swap [elements] [iterations]
+// Defaults to 1M elements and 20 iterations.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+
+#include "rmw_fastrtps_shared_cpp/byte_swap.hpp"
+
+using eprosima::fastcdr::Cdr;
+using eprosima::fastcdr::FastBuffer;
+
+using Clock = std::chrono::steady_clock;
+
+/// Run fun the given number of times and return the best time in milliseconds.
+template<typename Function>
+static double best_ms(size_t iterations, Function fun)
+{
+  double best = 0.0;
+  for (size_t i = 0; i < iterations; ++i) {
+    auto start = Clock::now();
+    fun();
+    double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    best = i == 0 ? elapsed : std::min(best, elapsed);
+  }
+  return best;
+}
+
+int main(int argc, char ** argv)
+{
+  const size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000u;
+  const size_t iterations = argc > 2 ? strtoul(argv[2], nullptr, 10) : 20u;
+  if (count < 2u || iterations == 0u) {
+    fprintf(stderr, "usage: %s [elements] [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<double> values(count);
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = static_cast<double>(i) * 0.5;
+  }
+  std::vector<char> buffer(count * sizeof(double) + 64);
+  FastBuffer fast_buffer(buffer.data(), buffer.size());
+  Cdr ser(fast_buffer, Cdr::BIG_ENDIANNESS, Cdr::DDS_CDR);
+  ser.serializeArray(values.data(), count);
+
+  std::vector<double> per_element(count);
+  double per_element_ms = best_ms(
+    iterations, [&]() {
+      Cdr deser(fast_buffer, Cdr::BIG_ENDIANNESS, Cdr::DDS_CDR);
+      deser.deserializeArray(per_element.data(), count);
+    });
+
+  std::vector<double> bulk(count);
+  double bulk_ms = best_ms(
+    iterations, [&]() {
+      Cdr deser(fast_buffer, Cdr::BIG_ENDIANNESS, Cdr::DDS_CDR);
+      deser.deserializeArray(bulk.data(), 1);
+      deser.deserializeArray(reinterpret_cast<uint8_t *>(bulk.data() + 1), (count - 1) * 8);
+      rmw_fastrtps_shared_cpp::byte_swap(bulk.data() + 1, count - 1);
+    });
+
+  if (per_element != values || bulk != values) {
+    fprintf(stderr, "deserialized values do not match\n");
+    return 1;
+  }
+
+  const double megabytes = count * sizeof(double) / 1e6;
+  printf("big endian float64[%zu], best of %zu\n", count, iterations);
+  printf(
+    "  per element  %8.3f ms  %8.1f MB/s\n", per_element_ms, megabytes / (per_element_ms / 1e3));
+  printf("  bulk         %8.3f ms  %8.1f MB/s\n", bulk_ms, megabytes / (bulk_ms / 1e3));
+  return 0;
+}
@@ -0,0 +1,254 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Replays synthetic discovery streams into a ParticipantListener and measures
+// the graph cache under load:
+//   benchmark_graph_cache [endpoints] [participants] [topics]
+// Defaults to 10000 endpoints spread over 1000 participants and 1000 topics.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "fastrtps/rtps/builtin/data/ReaderProxyData.h"
+#include "fastrtps/rtps/builtin/data/WriterProxyData.h"
+#include "fastrtps/rtps/reader/ReaderDiscoveryInfo.h"
+#include "fastrtps/rtps/writer/WriterDiscoveryInfo.h"
+
+#include "rcutils/allocator.h"
+
+#include "rmw/names_and_types.h"
+#include "rmw/rmw.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+
+using eprosima::fastrtps::rtps::GUID_t;
+using eprosima::fastrtps::rtps::GuidPrefix_t;
+using eprosima::fastrtps::rtps::InstanceHandle_t;
+using eprosima::fastrtps::rtps::ReaderDiscoveryInfo;
+using eprosima::fastrtps::rtps::ReaderProxyData;
+using eprosima::fastrtps::rtps::WriterDiscoveryInfo;
+using eprosima::fastrtps::rtps::WriterProxyData;
+
+using Clock = std::chrono::steady_clock;
+
+static const char * const kIdentifier = "benchmark_graph_cache";
+
+/// Return the peak resident set size of the process in kilobytes, 0 if unknown.
+static long peak_rss_kb()  // NOLINT(runtime/int)
+{
+#ifndef _WIN32
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    return usage.ru_maxrss;
+  }
+#endif
+  return 0;
+}
+
+static double elapsed_us(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+/// Print the mean, median, 99th percentile and maximum of a latency sample.
+static void print_latencies(const char * name, std::vector<double> & latencies_us)
+{
+  if (latencies_us.empty()) {
+    printf("  %-24s no samples\n", name);
+    return;
+  }
+  std::sort(latencies_us.begin(), latencies_us.end());
+  double sum = 0.0;
+  for (double latency : latencies_us) {
+    sum += latency;
+  }
+  printf(
+    "  %-24s n=%zu mean=%.1fus p50=%.1fus p99=%.1fus max=%.1fus\n", name,
+    latencies_us.size(), sum / latencies_us.size(),
+    latencies_us[latencies_us.size() / 2],
+    latencies_us[latencies_us.size() * 99 / 100],
+    latencies_us.back());
+}
+
+/**
+ * A synthetic endpoint, as announced by a remote shared participant.
+ */
+struct Endpoint
+{
+  bool is_reader;
+  std::unique_ptr<ReaderProxyData> reader;
+  std::unique_ptr<WriterProxyData> writer;
+};
+
+static std::vector<Endpoint> make_endpoints(
+  size_t endpoint_count, size_t participant_count, size_t topic_count)
+{
+  std::vector<Endpoint> endpoints(endpoint_count);
+  for (size_t i = 0; i < endpoint_count; ++i) {
+    const uint32_t participant = static_cast<uint32_t>(i % participant_count);
+    // a couple of nodes per participant
+    const uint32_t node_id = static_cast<uint32_t>((i / participant_count) % 4);
+
+    GuidPrefix_t prefix;
+    prefix.value[0] = static_cast<eprosima::fastrtps::rtps::octet>(participant & 0xFF);
+    prefix.value[1] = static_cast<eprosima::fastrtps::rtps::octet>((participant >> 8) & 0xFF);
+    prefix.value[2] = static_cast<eprosima::fastrtps::rtps::octet>((participant >> 16) & 0xFF);
+    GUID_t participant_guid(prefix, eprosima::fastrtps::rtps::c_EntityId_RTPSParticipant);
+    GUID_t endpoint_guid(prefix, static_cast<uint32_t>(i + 1) << 8);
+    InstanceHandle_t participant_key;
+    participant_key = participant_guid;
+
+    const std::string topic_name = "rt/topic_" + std::to_string(i % topic_count);
+    const std::string type_name = "std_msgs::msg::dds_::String_";
+    const auto user_data = rmw_fastrtps_shared_cpp::create_node_user_data(
+      ("node_" + std::to_string(participant) + "_" + std::to_string(node_id)).c_str(),
+      "/benchmark", node_id);
+
+    Endpoint & endpoint = endpoints[i];
+    endpoint.is_reader = (i % 2) == 0;
+    if (endpoint.is_reader) {
+      endpoint.reader.reset(new ReaderProxyData(1u, 1u));
+      endpoint.reader->guid(endpoint_guid);
+      endpoint.reader->RTPSParticipantKey(participant_key);
+      endpoint.reader->topicName(topic_name);
+      endpoint.reader->typeName(type_name);
+      endpoint.reader->m_qos.m_userData.setDataVec(user_data);
+    } else {
+      endpoint.writer.reset(new WriterProxyData(1u, 1u));
+      endpoint.writer->guid(endpoint_guid);
+      endpoint.writer->RTPSParticipantKey(participant_key);
+      endpoint.writer->topicName(topic_name);
+      endpoint.writer->typeName(type_name);
+      endpoint.writer->m_qos.m_userData.setDataVec(user_data);
+    }
+  }
+  return endpoints;
+}
+
+static void replay(::ParticipantListener & listener, const Endpoint & endpoint, bool is_alive)
+{
+  if (endpoint.is_reader) {
+    ReaderDiscoveryInfo info(*endpoint.reader);
+    info.status = is_alive ?
+      ReaderDiscoveryInfo::DISCOVERED_READER : ReaderDiscoveryInfo::REMOVED_READER;
+    listener.onSubscriberDiscovery(nullptr, std::move(info));
+  } else {
+    WriterDiscoveryInfo info(*endpoint.writer);
+    info.status = is_alive ?
+      WriterDiscoveryInfo::DISCOVERED_WRITER : WriterDiscoveryInfo::REMOVED_WRITER;
+    listener.onPublisherDiscovery(nullptr, std::move(info));
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  const size_t endpoint_count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10000u;
+  const size_t participant_count = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1000u;
+  const size_t topic_count = argc > 3 ? strtoul(argv[3], nullptr, 10) : 1000u;
+  if (endpoint_count == 0u || participant_count == 0u || topic_count == 0u) {
+    fprintf(stderr, "usage: %s [endpoints] [participants] [topics]\n", argv[0]);
+    return 1;
+  }
+
+  printf(
+    "graph cache: %zu endpoints, %zu participants, %zu topics\n",
+    endpoint_count, participant_count, topic_count);
+  const long rss_before = peak_rss_kb();  // NOLINT(runtime/int)
+  auto endpoints = make_endpoints(endpoint_count, participant_count, topic_count);
+
+  ::ParticipantListener listener;
+  CustomParticipantInfo participant_info{};
+  participant_info.listener = &listener;
+  rmw_node_t node{};
+  node.implementation_identifier = kIdentifier;
+  node.data = &participant_info;
+
+  // Add every endpoint
+  auto start = Clock::now();
+  for (const auto & endpoint : endpoints) {
+    replay(listener, endpoint, true);
+  }
+  double add_us = elapsed_us(start);
+  printf(
+    "  add                      %.0f endpoints/s\n", endpoint_count / (add_us / 1e6));
+  printf("  peak RSS after add       %ld kB\n", peak_rss_kb() - rss_before);
+
+  // Query while a quarter of the endpoints keep going away and coming back
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> churn_events{0u};
+  std::thread churn([&]() {
+      const size_t churn_count = std::max<size_t>(endpoint_count / 4u, 1u);
+      while (!stop.load()) {
+        for (size_t i = 0; i < churn_count && !stop.load(); ++i) {
+          replay(listener, endpoints[i], false);
+          replay(listener, endpoints[i], true);
+          churn_events.fetch_add(2u);
+        }
+      }
+    });
+
+  std::vector<double> count_latencies;
+  std::vector<double> names_and_types_latencies;
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  start = Clock::now();
+  for (size_t i = 0; i < 1000u; ++i) {
+    const std::string topic_name = "/topic_" + std::to_string(i % topic_count);
+    size_t count = 0u;
+    auto query_start = Clock::now();
+    rmw_fastrtps_shared_cpp::__rmw_count_publishers(
+      kIdentifier, &node, topic_name.c_str(), &count);
+    rmw_fastrtps_shared_cpp::__rmw_count_subscribers(
+      kIdentifier, &node, topic_name.c_str(), &count);
+    count_latencies.push_back(elapsed_us(query_start));
+
+    if (i % 10u == 0u) {
+      rmw_names_and_types_t topic_names_and_types = rmw_get_zero_initialized_names_and_types();
+      query_start = Clock::now();
+      rmw_fastrtps_shared_cpp::__rmw_get_topic_names_and_types(
+        kIdentifier, &node, &allocator, false, &topic_names_and_types);
+      names_and_types_latencies.push_back(elapsed_us(query_start));
+      rmw_names_and_types_fini(&topic_names_and_types);
+    }
+  }
+  double query_us = elapsed_us(start);
+  stop.store(true);
+  churn.join();
+  printf(
+    "  churn during queries     %.0f events/s\n", churn_events.load() / (query_us / 1e6));
+  print_latencies("count (pub + sub)", count_latencies);
+  print_latencies("topic names and types", names_and_types_latencies);
+
+  // Remove every endpoint
+  start = Clock::now();
+  for (const auto & endpoint : endpoints) {
+    replay(listener, endpoint, false);
+  }
+  double remove_us = elapsed_us(start);
+  printf(
+    "  remove                   %.0f endpoints/s\n", endpoint_count / (remove_us / 1e6));
+  printf("  peak RSS                 %ld kB\n", peak_rss_kb() - rss_before);
+  return 0;
+}
@@ -0,0 +1,312 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the latency of publishing in synchronous and asynchronous publish mode, from a
+// publisher to a subscription of the same participant:
+//   benchmark_publish_mode [messages] [min_size] [max_size]
+// Defaults to 1000 messages of each size from 64 bytes to 64 KiB, the size quadrupling.
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "fastrtps/Domain.h"
+#include "fastrtps/attributes/ParticipantAttributes.h"
+#include "fastrtps/attributes/PublisherAttributes.h"
+#include "fastrtps/attributes/SubscriberAttributes.h"
+#include "fastrtps/participant/Participant.h"
+#include "fastrtps/publisher/Publisher.h"
+#include "fastrtps/publisher/PublisherListener.h"
+#include "fastrtps/subscriber/SampleInfo.h"
+#include "fastrtps/subscriber/Subscriber.h"
+#include "fastrtps/subscriber/SubscriberListener.h"
+
+#include "rcutils/allocator.h"
+
+#include "rmw/serialized_message.h"
+
+#include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
+#include "rmw_fastrtps_shared_cpp/publish_mode.hpp"
+
+using eprosima::fastrtps::Domain;
+using eprosima::fastrtps::Participant;
+using eprosima::fastrtps::Publisher;
+using eprosima::fastrtps::PublishModeQosPolicyKind;
+using eprosima::fastrtps::Subscriber;
+
+using Clock = std::chrono::steady_clock;
+
+// Messages are published as serialized messages, the first bytes holding the time they were sent
+class RawTypeSupport : public rmw_fastrtps_shared_cpp::TypeSupport
+{
+public:
+  RawTypeSupport()
+  {
+    setName("benchmark_publish_mode::RawBytes");
+    m_typeSize = 64;
+  }
+
+  size_t getEstimatedSerializedSize(const void *, const void *) const override
+  {
+    return 0;
+  }
+
+  bool serializeROSmessage(const void *, eprosima::fastcdr::Cdr &, const void *) const override
+  {
+    return false;
+  }
+
+  bool deserializeROSmessage(eprosima::fastcdr::Cdr &, void *, const void *) const override
+  {
+    return false;
+  }
+};
+
+class Listener : public eprosima::fastrtps::SubscriberListener,
+  public eprosima::fastrtps::PublisherListener
+{
+public:
+  Listener()
+  {
+    message_ = rmw_get_zero_initialized_serialized_message();
+    rcutils_allocator_t allocator = rcutils_get_default_allocator();
+    if (rmw_serialized_message_init(&message_, 64, &allocator) != RMW_RET_OK) {
+      abort();
+    }
+  }
+
+  ~Listener()
+  {
+    rmw_serialized_message_fini(&message_);
+  }
+
+  void onSubscriptionMatched(Subscriber *, eprosima::fastrtps::rtps::MatchingInfo & info) override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    matched_reader_ = info.status == eprosima::fastrtps::rtps::MATCHED_MATCHING;
+    cv_.notify_all();
+  }
+
+  void onPublicationMatched(Publisher *, eprosima::fastrtps::rtps::MatchingInfo & info) override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    matched_writer_ = info.status == eprosima::fastrtps::rtps::MATCHED_MATCHING;
+    cv_.notify_all();
+  }
+
+  void onNewDataMessage(Subscriber * sub) override
+  {
+    rmw_fastrtps_shared_cpp::SerializedData data;
+    data.is_cdr_buffer = true;
+    data.data = nullptr;
+    data.impl = nullptr;
+    data.serialized_message = &message_;
+    eprosima::fastrtps::SampleInfo_t info;
+    while (sub->takeNextData(&data, &info)) {
+      auto now = Clock::now().time_since_epoch().count();
+      Clock::rep sent;
+      memcpy(&sent, message_.buffer, sizeof(sent));
+      std::lock_guard<std::mutex> lock(mutex_);
+      latency_ns_ = static_cast<double>(now - sent);
+      received_ = true;
+      cv_.notify_all();
+    }
+  }
+
+  bool wait_for_match(std::chrono::seconds timeout)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, timeout, [this]() {return matched_reader_ && matched_writer_;});
+  }
+
+  /// Latency in nanoseconds of the next message received, negative if none is within timeout.
+  double wait_for_message(std::chrono::milliseconds timeout)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!cv_.wait_for(lock, timeout, [this]() {return received_;})) {
+      return -1.0;
+    }
+    received_ = false;
+    return latency_ns_;
+  }
+
+private:
+  rmw_serialized_message_t message_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool matched_reader_ = false;
+  bool matched_writer_ = false;
+  bool received_ = false;
+  double latency_ns_ = 0.0;
+};
+
+struct Result
+{
+  bool ok;
+  double write_us;
+  double median_us;
+  double p99_us;
+};
+
+static double percentile(std::vector<double> & values, double fraction)
+{
+  size_t index = static_cast<size_t>(fraction * (values.size() - 1));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index] / 1000.0;
+}
+
+/// Publish messages one at a time, each once the previous one was received.
+static Result measure(
+  Publisher * publisher, Listener & listener, size_t messages, size_t size)
+{
+  rmw_serialized_message_t message = rmw_get_zero_initialized_serialized_message();
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  if (rmw_serialized_message_init(&message, size, &allocator) != RMW_RET_OK) {
+    abort();
+  }
+  memset(message.buffer, 0x5a, size);
+  message.buffer_length = size;
+
+  rmw_fastrtps_shared_cpp::SerializedData data;
+  data.is_cdr_buffer = true;
+  data.data = nullptr;
+  data.impl = nullptr;
+  data.serialized_message = &message;
+
+  Result result{true, 0.0, 0.0, 0.0};
+  std::vector<double> latencies;
+  double write_ns = 0.0;
+  // The first tenth warms up the history and the transports
+  const size_t warmup = messages / 10;
+  for (size_t i = 0; i < warmup + messages && result.ok; ++i) {
+    auto start = Clock::now();
+    Clock::rep sent = start.time_since_epoch().count();
+    memcpy(message.buffer, &sent, sizeof(sent));
+    result.ok = publisher->write(&data);
+    auto written = Clock::now();
+    double latency = result.ok ? listener.wait_for_message(std::chrono::milliseconds(1000)) : -1.0;
+    result.ok = latency >= 0.0;
+    if (i >= warmup) {
+      write_ns += std::chrono::duration<double, std::nano>(written - start).count();
+      latencies.push_back(latency);
+    }
+  }
+  rmw_serialized_message_fini(&message);
+  if (result.ok) {
+    result.write_us = write_ns / messages / 1000.0;
+    result.median_us = percentile(latencies, 0.5);
+    result.p99_us = percentile(latencies, 0.99);
+  }
+  return result;
+}
+
+int main(int argc, char ** argv)
+{
+  const size_t messages = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000u;
+  const size_t min_size = argc > 2 ? strtoul(argv[2], nullptr, 10) : 64u;
+  const size_t max_size = argc > 3 ? strtoul(argv[3], nullptr, 10) : 64u * 1024u;
+  if (messages == 0u || min_size < sizeof(Clock::rep) || max_size < min_size) {
+    fprintf(stderr, "usage: %s [messages] [min_size] [max_size]\n", argv[0]);
+    return 1;
+  }
+
+  eprosima::fastrtps::ParticipantAttributes participant_attributes;
+  Domain::getDefaultParticipantAttributes(participant_attributes);
+  participant_attributes.rtps.setName("benchmark_publish_mode");
+  Participant * participant = Domain::createParticipant(participant_attributes);
+  if (!participant) {
+    fprintf(stderr, "failed to create participant\n");
+    return 1;
+  }
+  RawTypeSupport type_support;
+  Domain::registerType(participant, &type_support);
+
+  const char * mode_names[] = {"SYNCHRONOUS", "ASYNCHRONOUS"};
+  std::vector<Result> results[2];
+  for (size_t mode = 0; mode < 2; ++mode) {
+    PublishModeQosPolicyKind kind;
+    rmw_fastrtps_shared_cpp::parse_publish_mode(mode_names[mode], kind);
+    std::string topic_name = std::string("rt/benchmark_publish_mode_") + mode_names[mode];
+
+    // As rmw creates them by default, but for the publish mode
+    eprosima::fastrtps::PublisherAttributes publisher_attributes;
+    Domain::getDefaultPublisherAttributes(publisher_attributes);
+    publisher_attributes.topic.topicKind = eprosima::fastrtps::rtps::NO_KEY;
+    publisher_attributes.topic.topicDataType = type_support.getName();
+    publisher_attributes.topic.topicName = topic_name;
+    publisher_attributes.topic.historyQos.kind = eprosima::fastrtps::KEEP_LAST_HISTORY_QOS;
+    publisher_attributes.topic.historyQos.depth = 10;
+    publisher_attributes.qos.m_reliability.kind = eprosima::fastrtps::RELIABLE_RELIABILITY_QOS;
+    publisher_attributes.qos.m_publishMode.kind = kind;
+    publisher_attributes.historyMemoryPolicy =
+      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+
+    eprosima::fastrtps::SubscriberAttributes subscriber_attributes;
+    Domain::getDefaultSubscriberAttributes(subscriber_attributes);
+    subscriber_attributes.topic.topicKind = eprosima::fastrtps::rtps::NO_KEY;
+    subscriber_attributes.topic.topicDataType = type_support.getName();
+    subscriber_attributes.topic.topicName = topic_name;
+    subscriber_attributes.topic.historyQos.kind = eprosima::fastrtps::KEEP_LAST_HISTORY_QOS;
+    subscriber_attributes.topic.historyQos.depth = 10;
+    subscriber_attributes.qos.m_reliability.kind = eprosima::fastrtps::RELIABLE_RELIABILITY_QOS;
+    subscriber_attributes.historyMemoryPolicy =
+      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+
+    Listener listener;
+    Subscriber * subscriber =
+      Domain::createSubscriber(participant, subscriber_attributes, &listener);
+    Publisher * publisher = Domain::createPublisher(participant, publisher_attributes, &listener);
+    if (!subscriber || !publisher || !listener.wait_for_match(std::chrono::seconds(10))) {
+      fprintf(stderr, "failed to match a %s publisher\n", mode_names[mode]);
+      Domain::removeParticipant(participant);
+      return 1;
+    }
+
+    for (size_t size = min_size; size <= max_size; size *= 4) {
+      results[mode].push_back(measure(publisher, listener, messages, size));
+    }
+    Domain::removePublisher(publisher);
+    Domain::removeSubscriber(subscriber);
+  }
+  Domain::removeParticipant(participant);
+
+  printf(
+    "%zu messages of each size, time spent in write() then median and 99th percentile latency,"
+    " in us\n", messages);
+  printf(
+    "%10s  %10s %10s %10s  %10s %10s %10s\n",
+    "size", "sync", "median", "p99", "async", "median", "p99");
+  size_t i = 0;
+  for (size_t size = min_size; size <= max_size; size *= 4, ++i) {
+    printf("%8zu B", size);
+    for (size_t mode = 0; mode < 2; ++mode) {
+      const Result & result = results[mode][i];
+      if (result.ok) {
+        printf("  %10.1f %10.1f %10.1f", result.write_us, result.median_us, result.p99_us);
+      } else {
+        // Synchronous writers cannot fragment samples
+        printf("  %32s", "failed");
+      }
+    }
+    printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,85 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "rmw_fastrtps_shared_cpp/byte_swap.hpp"
+
+template<typename T>
+static T reversed(T value)
+{
+  T result;
+  auto from = reinterpret_cast<const unsigned char *>(&value);
+  auto to = reinterpret_cast<unsigned char *>(&result);
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    to[i] = from[sizeof(T) - 1 - i];
+  }
+  return result;
+}
+
+// Cover empty arrays, arrays shorter than a vector, and every possible tail length
+template<typename T>
+static void check_byte_swap()
+{
+  for (size_t count = 0; count < 100; ++count) {
+    std::vector<T> data(count);
+    auto bytes = reinterpret_cast<unsigned char *>(data.data());
+    for (size_t i = 0; i < count * sizeof(T); ++i) {
+      bytes[i] = static_cast<unsigned char>(i * 37 + 5);
+    }
+    std::vector<T> expected(count);
+    for (size_t i = 0; i < count; ++i) {
+      expected[i] = reversed(data[i]);
+    }
+
+    rmw_fastrtps_shared_cpp::byte_swap(data.data(), count);
+    if (count > 0) {
+      EXPECT_EQ(0, memcmp(expected.data(), data.data(), count * sizeof(T))) << count;
+    }
+  }
+}
+
+TEST(ByteSwapTest, swaps_16_bit_elements) {
+  check_byte_swap<uint16_t>();
+  check_byte_swap<int16_t>();
+}
+
+TEST(ByteSwapTest, swaps_32_bit_elements) {
+  check_byte_swap<uint32_t>();
+  check_byte_swap<float>();
+}
+
+TEST(ByteSwapTest, swaps_64_bit_elements) {
+  check_byte_swap<uint64_t>();
+  check_byte_swap<double>();
+}
+
+TEST(ByteSwapTest, swaps_unaligned_arrays) {
+  std::vector<unsigned char> buffer(3 + 40 * sizeof(uint32_t));
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = static_cast<unsigned char>(i);
+  }
+  std::vector<unsigned char> expected(buffer);
+  for (size_t i = 0; i < 40; ++i) {
+    for (size_t j = 0; j < sizeof(uint32_t); ++j) {
+      expected[3 + i * 4 + j] = buffer[3 + i * 4 + 3 - j];
+    }
+  }
+
+  rmw_fastrtps_shared_cpp::byte_swap_32(reinterpret_cast<uint32_t *>(buffer.data() + 3), 40);
+  EXPECT_EQ(expected, buffer);
+}
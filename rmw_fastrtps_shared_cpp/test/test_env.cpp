@@ -0,0 +1,73 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+
+#include "rmw_fastrtps_shared_cpp/env.hpp"
+
+using rmw_fastrtps_shared_cpp::get_env_uint;
+
+static void set_env(const char * name, const char * value)
+{
+#ifdef _WIN32
+  _putenv_s(name, value);
+#else
+  setenv(name, value, 1);
+#endif
+}
+
+TEST(EnvTest, unset_or_empty_is_not_read) {
+  const char * env_var = "RMW_FASTRTPS_TEST_ENV_UINT";
+  uint64_t value = 7;
+  set_env(env_var, "");
+  EXPECT_FALSE(get_env_uint(env_var, UINT32_MAX, "ignored", value));
+  EXPECT_EQ(7u, value);
+  EXPECT_FALSE(get_env_uint("RMW_FASTRTPS_TEST_ENV_UNSET", UINT32_MAX, "ignored", value));
+  EXPECT_EQ(7u, value);
+}
+
+TEST(EnvTest, valid_values_are_read) {
+  const char * env_var = "RMW_FASTRTPS_TEST_ENV_UINT";
+  uint64_t value = 7;
+  set_env(env_var, "0");
+  EXPECT_TRUE(get_env_uint(env_var, UINT32_MAX, "ignored", value));
+  EXPECT_EQ(0u, value);
+  set_env(env_var, "4294967295");
+  EXPECT_TRUE(get_env_uint(env_var, UINT32_MAX, "ignored", value));
+  EXPECT_EQ(UINT32_MAX, value);
+}
+
+TEST(EnvTest, invalid_values_are_ignored) {
+  const char * env_var = "RMW_FASTRTPS_TEST_ENV_UINT";
+  for (const char * invalid : {
+      "12ms", "-1", " -1", "\t5", "+5", "4294967296", "18446744073709551616", "abc"})
+  {
+    uint64_t value = 7;
+    set_env(env_var, invalid);
+    EXPECT_FALSE(get_env_uint(env_var, UINT32_MAX, "ignored", value)) << invalid;
+    EXPECT_EQ(7u, value) << invalid;
+  }
+}
+
+TEST(EnvTest, out_of_range_values_are_ignored_whatever_the_maximum) {
+  const char * env_var = "RMW_FASTRTPS_TEST_ENV_UINT";
+  uint64_t value = 7;
+  set_env(env_var, "18446744073709551616");
+  EXPECT_FALSE(get_env_uint(env_var, UINT64_MAX, "ignored", value));
+  EXPECT_EQ(7u, value);
+}
@@ -0,0 +1,155 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+#include "fastrtps/rtps/builtin/data/WriterProxyData.h"
+#include "fastrtps/rtps/writer/WriterDiscoveryInfo.h"
+
+#include "rmw/rmw.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+
+using eprosima::fastrtps::rtps::GUID_t;
+using eprosima::fastrtps::rtps::GuidPrefix_t;
+using eprosima::fastrtps::rtps::InstanceHandle_t;
+using eprosima::fastrtps::rtps::WriterDiscoveryInfo;
+using eprosima::fastrtps::rtps::WriterProxyData;
+
+static const char * const kIdentifier = "test_graph_notifications";
+
+class GraphNotificationsTest : public ::testing::Test
+{
+public:
+  void SetUp() override
+  {
+    context.implementation_identifier = kIdentifier;
+    wait_set = rmw_fastrtps_shared_cpp::__rmw_create_wait_set(kIdentifier, &context, 1u);
+    ASSERT_NE(nullptr, wait_set);
+    graph_guard_condition = rmw_fastrtps_shared_cpp::__rmw_create_guard_condition(kIdentifier);
+    ASSERT_NE(nullptr, graph_guard_condition);
+  }
+
+  void TearDown() override
+  {
+    EXPECT_EQ(
+      RMW_RET_OK, rmw_fastrtps_shared_cpp::__rmw_destroy_guard_condition(graph_guard_condition));
+    EXPECT_EQ(RMW_RET_OK, rmw_fastrtps_shared_cpp::__rmw_destroy_wait_set(kIdentifier, wait_set));
+  }
+
+  /// Whether the graph guard condition is triggered within timeout, resetting it.
+  bool triggered(std::chrono::milliseconds timeout)
+  {
+    void * guard_condition_data = graph_guard_condition->data;
+    rmw_guard_conditions_t guard_conditions{1u, &guard_condition_data};
+    rmw_time_t wait_timeout{
+      static_cast<uint64_t>(timeout.count() / 1000),
+      static_cast<uint64_t>((timeout.count() % 1000) * 1000000)};
+    rmw_fastrtps_shared_cpp::__rmw_wait(
+      nullptr, &guard_conditions, nullptr, nullptr, nullptr, wait_set, &wait_timeout);
+    return guard_condition_data != nullptr;
+  }
+
+  /// Announce a remote publisher, or its removal.
+  static void discover_publisher(
+    ::ParticipantListener & listener, uint32_t id, const std::string & topic_name, bool is_alive)
+  {
+    GuidPrefix_t prefix;
+    prefix.value[0] = 1;
+    GUID_t participant_guid(prefix, eprosima::fastrtps::rtps::c_EntityId_RTPSParticipant);
+    InstanceHandle_t participant_key;
+    participant_key = participant_guid;
+
+    WriterProxyData writer(1u, 1u);
+    writer.guid(GUID_t(prefix, id << 8));
+    writer.RTPSParticipantKey(participant_key);
+    writer.topicName(topic_name);
+    writer.typeName("std_msgs::msg::dds_::String_");
+    WriterDiscoveryInfo info(writer);
+    info.status = is_alive ?
+      WriterDiscoveryInfo::DISCOVERED_WRITER : WriterDiscoveryInfo::REMOVED_WRITER;
+    listener.onPublisherDiscovery(nullptr, std::move(info));
+  }
+
+  rmw_context_t context{};
+  rmw_wait_set_t * wait_set = nullptr;
+  rmw_guard_condition_t * graph_guard_condition = nullptr;
+};
+
+TEST_F(GraphNotificationsTest, every_change_triggers_without_period) {
+  ::ParticipantListener listener;
+  listener.attach_graph_guard_condition(graph_guard_condition);
+  discover_publisher(listener, 1u, "rt/chatter", true);
+  EXPECT_TRUE(triggered(std::chrono::milliseconds(0)));
+  EXPECT_FALSE(triggered(std::chrono::milliseconds(0)));
+  discover_publisher(listener, 1u, "rt/chatter", false);
+  EXPECT_TRUE(triggered(std::chrono::milliseconds(0)));
+  listener.detach_graph_guard_condition(graph_guard_condition);
+}
+
+TEST_F(GraphNotificationsTest, changes_within_the_period_are_coalesced) {
+  ::ParticipantListener listener(std::chrono::milliseconds(500));
+  listener.attach_graph_guard_condition(graph_guard_condition);
+  for (uint32_t id = 1u; id <= 10u; ++id) {
+    discover_publisher(listener, id, "rt/topic_" + std::to_string(id), true);
+  }
+  // Held back until the end of the period started by the first change
+  EXPECT_FALSE(triggered(std::chrono::milliseconds(0)));
+  EXPECT_TRUE(triggered(std::chrono::milliseconds(5000)));
+  // All of them reported by that single trigger
+  EXPECT_FALSE(triggered(std::chrono::milliseconds(1000)));
+
+  discover_publisher(listener, 1u, "rt/topic_1", false);
+  EXPECT_TRUE(triggered(std::chrono::milliseconds(5000)));
+  listener.detach_graph_guard_condition(graph_guard_condition);
+}
+
+TEST_F(GraphNotificationsTest, changed_topics_are_taken_once) {
+  ::ParticipantListener listener;
+  listener.attach_graph_guard_condition(graph_guard_condition);
+
+  // Nothing is recorded before the first take
+  discover_publisher(listener, 1u, "rt/chatter", true);
+  EXPECT_TRUE(listener.take_changed_topics(graph_guard_condition).empty());
+
+  discover_publisher(listener, 1u, "rt/chatter", false);
+  discover_publisher(listener, 2u, "rt/rosout", true);
+  discover_publisher(listener, 3u, "rt/rosout", true);
+  EXPECT_EQ(
+    (std::set<std::string>{"rt/chatter", "rt/rosout"}),
+    listener.take_changed_topics(graph_guard_condition));
+  EXPECT_TRUE(listener.take_changed_topics(graph_guard_condition).empty());
+
+  // Guard conditions which never took their changes do not record them
+  rmw_guard_condition_t * other_guard_condition =
+    rmw_fastrtps_shared_cpp::__rmw_create_guard_condition(kIdentifier);
+  ASSERT_NE(nullptr, other_guard_condition);
+  listener.attach_graph_guard_condition(other_guard_condition);
+  discover_publisher(listener, 4u, "rt/parameter_events", true);
+  EXPECT_TRUE(listener.take_changed_topics(other_guard_condition).empty());
+  EXPECT_EQ(
+    (std::set<std::string>{"rt/parameter_events"}),
+    listener.take_changed_topics(graph_guard_condition));
+
+  listener.detach_graph_guard_condition(other_guard_condition);
+  listener.detach_graph_guard_condition(graph_guard_condition);
+  EXPECT_EQ(
+    RMW_RET_OK, rmw_fastrtps_shared_cpp::__rmw_destroy_guard_condition(other_guard_condition));
+}
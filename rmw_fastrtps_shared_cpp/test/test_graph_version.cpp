@@ -0,0 +1,121 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+#include "fastrtps/rtps/builtin/data/WriterProxyData.h"
+#include "fastrtps/rtps/writer/WriterDiscoveryInfo.h"
+
+#include "rcutils/allocator.h"
+
+#include "rmw/names_and_types.h"
+#include "rmw/rmw.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+
+using eprosima::fastrtps::rtps::GUID_t;
+using eprosima::fastrtps::rtps::GuidPrefix_t;
+using eprosima::fastrtps::rtps::InstanceHandle_t;
+using eprosima::fastrtps::rtps::WriterDiscoveryInfo;
+using eprosima::fastrtps::rtps::WriterProxyData;
+
+static const char * const kIdentifier = "test_graph_version";
+
+class GraphVersionTest : public ::testing::Test
+{
+public:
+  void SetUp() override
+  {
+    participant_info.listener = &listener;
+    node.implementation_identifier = kIdentifier;
+    node.data = &participant_info;
+  }
+
+  /// Announce a remote publisher, or its removal.
+  void discover_publisher(uint32_t id, const std::string & topic_name, bool is_alive)
+  {
+    GuidPrefix_t prefix;
+    prefix.value[0] = 1;
+    GUID_t participant_guid(prefix, eprosima::fastrtps::rtps::c_EntityId_RTPSParticipant);
+    InstanceHandle_t participant_key;
+    participant_key = participant_guid;
+
+    WriterProxyData writer(1u, 1u);
+    writer.guid(GUID_t(prefix, id << 8));
+    writer.RTPSParticipantKey(participant_key);
+    writer.topicName(topic_name);
+    writer.typeName("std_msgs::msg::dds_::String_");
+    WriterDiscoveryInfo info(writer);
+    info.status = is_alive ?
+      WriterDiscoveryInfo::DISCOVERED_WRITER : WriterDiscoveryInfo::REMOVED_WRITER;
+    listener.onPublisherDiscovery(nullptr, std::move(info));
+  }
+
+  /// Number of topics reported by rmw_get_topic_names_and_types().
+  size_t count_topics()
+  {
+    rcutils_allocator_t allocator = rcutils_get_default_allocator();
+    rmw_names_and_types_t topics = rmw_get_zero_initialized_names_and_types();
+    EXPECT_EQ(
+      RMW_RET_OK, rmw_fastrtps_shared_cpp::__rmw_get_topic_names_and_types(
+        kIdentifier, &node, &allocator, false, &topics));
+    size_t count = topics.names.size;
+    EXPECT_EQ(RMW_RET_OK, rmw_names_and_types_fini(&topics));
+    return count;
+  }
+
+  ::ParticipantListener listener;
+  CustomParticipantInfo participant_info{};
+  rmw_node_t node{};
+};
+
+TEST_F(GraphVersionTest, bumped_by_discovery) {
+  uint64_t version = listener.get_graph_version();
+  EXPECT_EQ(1u, version);
+
+  discover_publisher(1u, "rt/chatter", true);
+  EXPECT_LT(version, listener.get_graph_version());
+  version = listener.get_graph_version();
+
+  discover_publisher(1u, "rt/chatter", false);
+  EXPECT_LT(version, listener.get_graph_version());
+}
+
+TEST_F(GraphVersionTest, cached_topic_names_and_types_invalidated) {
+  discover_publisher(1u, "rt/chatter", true);
+  EXPECT_EQ(1u, count_topics());
+
+  // The result is cached for the current version, in the requested flavor only
+  const uint64_t version = listener.get_graph_version();
+  auto cached = listener.get_cached_topic_names_and_types(version, false);
+  ASSERT_NE(nullptr, cached);
+  EXPECT_EQ(1u, cached->count("/chatter"));
+  EXPECT_EQ(nullptr, listener.get_cached_topic_names_and_types(version, true));
+  EXPECT_EQ(1u, count_topics());
+  EXPECT_EQ(cached, listener.get_cached_topic_names_and_types(version, false));
+
+  discover_publisher(2u, "rt/rosout", true);
+  EXPECT_EQ(
+    nullptr,
+    listener.get_cached_topic_names_and_types(listener.get_graph_version(), false));
+  EXPECT_EQ(2u, count_topics());
+
+  discover_publisher(1u, "rt/chatter", false);
+  EXPECT_EQ(1u, count_topics());
+}
@@ -0,0 +1,71 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "rmw_fastrtps_shared_cpp/history_memory_policy.hpp"
+#include "rmw_fastrtps_shared_cpp/topic_config.hpp"
+
+using eprosima::fastrtps::rtps::MemoryManagementPolicy_t;
+using rmw_fastrtps_shared_cpp::match_topic_config;
+
+TEST(TopicConfigTest, first_matching_entry_wins) {
+  const std::string config = "/cmd_vel=A,/control/*=B,*=C";
+  EXPECT_EQ("A", match_topic_config(config, "/cmd_vel"));
+  EXPECT_EQ("B", match_topic_config(config, "/control/joint_states"));
+  EXPECT_EQ("C", match_topic_config(config, "/cmd_vel_raw"));
+  EXPECT_EQ("C", match_topic_config(config, "/control"));
+}
+
+TEST(TopicConfigTest, no_matching_entry) {
+  EXPECT_EQ("", match_topic_config("", "/chatter"));
+  EXPECT_EQ("", match_topic_config("/cmd_vel=A,/control/*=B", "/chatter"));
+  // Entries without a value are skipped
+  EXPECT_EQ("", match_topic_config("/chatter", "/chatter"));
+  EXPECT_EQ("B", match_topic_config("/chatter,/chat*=B", "/chatter"));
+  EXPECT_EQ("", match_topic_config("/chatter=", "/chatter"));
+}
+
+TEST(HistoryMemoryPolicyTest, parse) {
+  MemoryManagementPolicy_t policy;
+  ASSERT_TRUE(rmw_fastrtps_shared_cpp::parse_history_memory_policy("PREALLOCATED", policy));
+  EXPECT_EQ(eprosima::fastrtps::rtps::PREALLOCATED_MEMORY_MODE, policy);
+  ASSERT_TRUE(
+    rmw_fastrtps_shared_cpp::parse_history_memory_policy("PREALLOCATED_WITH_REALLOC", policy));
+  EXPECT_EQ(eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE, policy);
+  ASSERT_TRUE(rmw_fastrtps_shared_cpp::parse_history_memory_policy("DYNAMIC", policy));
+  EXPECT_EQ(eprosima::fastrtps::rtps::DYNAMIC_RESERVE_MEMORY_MODE, policy);
+  EXPECT_FALSE(rmw_fastrtps_shared_cpp::parse_history_memory_policy("dynamic", policy));
+  EXPECT_FALSE(rmw_fastrtps_shared_cpp::parse_history_memory_policy("", policy));
+}
+
+TEST(HistoryMemoryPolicyTest, chosen_from_the_type) {
+  using rmw_fastrtps_shared_cpp::get_history_memory_policy;
+  using rmw_fastrtps_shared_cpp::max_preallocated_type_size;
+  const char * topic = "/history_memory_policy_test";
+  EXPECT_EQ(
+    eprosima::fastrtps::rtps::PREALLOCATED_MEMORY_MODE,
+    get_history_memory_policy(topic, true, 44));
+  EXPECT_EQ(
+    eprosima::fastrtps::rtps::PREALLOCATED_MEMORY_MODE,
+    get_history_memory_policy(topic, true, max_preallocated_type_size));
+  EXPECT_EQ(
+    eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE,
+    get_history_memory_policy(topic, true, max_preallocated_type_size + 1));
+  EXPECT_EQ(
+    eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE,
+    get_history_memory_policy(topic, false, 44));
+}
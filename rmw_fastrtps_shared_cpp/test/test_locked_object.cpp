@@ -0,0 +1,102 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "rmw_fastrtps_shared_cpp/locked_object.hpp"
+
+TEST(LockedObjectTest, snapshot_published_after_modification) {
+  LockedObject<std::map<std::string, int>> object;
+  auto empty = object.getSnapshot();
+  ASSERT_NE(nullptr, empty);
+  EXPECT_TRUE(empty->empty());
+
+  {
+    std::lock_guard<std::mutex> guard(object.getMutex());
+    object()["/chatter"] = 1;
+    // Not published yet
+    EXPECT_TRUE(object.getSnapshot()->empty());
+    object.markModified();
+  }
+  auto snapshot = object.getSnapshot();
+  EXPECT_EQ(1u, snapshot->size());
+  // Shared by the readers until the next modification
+  EXPECT_EQ(snapshot, object.getSnapshot());
+
+  {
+    std::lock_guard<std::mutex> guard(object.getMutex());
+    object()["/rosout"] = 2;
+    object.markModified();
+  }
+  // Older snapshots are left untouched
+  EXPECT_EQ(1u, snapshot->size());
+  EXPECT_TRUE(empty->empty());
+  EXPECT_EQ(2u, object.getSnapshot()->size());
+}
+
+namespace
+{
+
+struct CountedCopies
+{
+  CountedCopies() = default;
+
+  CountedCopies(const CountedCopies & other)
+  : values(other.values)
+  {
+    ++copies;
+  }
+
+  std::vector<int> values;
+  static size_t copies;
+};
+
+size_t CountedCopies::copies = 0;
+
+}  // namespace
+
+TEST(LockedObjectTest, one_copy_per_burst_of_modifications) {
+  LockedObject<CountedCopies> object;
+  CountedCopies::copies = 0;
+  auto modify = [&object](int value) {
+      std::lock_guard<std::mutex> guard(object.getMutex());
+      object().values.push_back(value);
+      object.markModified();
+    };
+
+  // The initial snapshot is shared with the object, the first modification copies it
+  for (int i = 0; i < 100; ++i) {
+    modify(i);
+  }
+  EXPECT_EQ(1u, CountedCopies::copies);
+
+  // Publishing does not copy
+  auto snapshot = object.getSnapshot();
+  EXPECT_EQ(100u, snapshot->values.size());
+  EXPECT_EQ(snapshot, object.getSnapshot());
+  EXPECT_EQ(1u, CountedCopies::copies);
+
+  for (int i = 0; i < 100; ++i) {
+    modify(i);
+  }
+  EXPECT_EQ(2u, CountedCopies::copies);
+  EXPECT_EQ(100u, snapshot->values.size());
+  EXPECT_EQ(200u, object.getSnapshot()->values.size());
+  EXPECT_EQ(2u, CountedCopies::copies);
+}
@@ -0,0 +1,94 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "fastrtps/rtps/common/SerializedPayload.h"
+
+#include "rmw_fastrtps_shared_cpp/payload_sizing.hpp"
+
+using eprosima::fastrtps::rtps::SerializedPayload_t;
+using rmw_fastrtps_shared_cpp::PayloadSizing;
+
+// Writer history in PREALLOCATED_WITH_REALLOC_MEMORY_MODE, its payloads used in turn
+class History
+{
+public:
+  History(size_t depth, uint32_t initial_size)
+  : payloads_(depth)
+  {
+    for (auto & payload : payloads_) {
+      payload.reserve(initial_size);
+    }
+  }
+
+  void write(PayloadSizing & sizing, uint32_t size)
+  {
+    SerializedPayload_t & payload = payloads_[next_++ % payloads_.size()];
+    uint32_t reserved = sizing.reserve(size);
+    ASSERT_LE(size, reserved);
+    if (reserved > payload.max_size) {
+      payload.reserve(reserved);
+    }
+    sizing.on_reserved(payload);
+  }
+
+private:
+  std::vector<SerializedPayload_t> payloads_;
+  size_t next_ = 0;
+};
+
+TEST(PayloadSizingTest, payloads_are_grown_to_the_high_water_mark) {
+  PayloadSizing sizing(16, 64);
+  History history(10, 16);
+  // Slowly growing messages, like a path or a map being built
+  for (uint32_t i = 1; i <= 100; ++i) {
+    history.write(sizing, 100 * i);
+  }
+
+  auto stats = sizing.stats();
+  EXPECT_EQ(100u, stats.samples);
+  EXPECT_EQ(10000u, stats.reserved_size);
+  // Every sample is the largest so far, and lands in a payload last sized for an older one
+  EXPECT_EQ(100u, stats.reallocations);
+  EXPECT_EQ(100u, stats.reallocations_without_presizing);
+}
+
+TEST(PayloadSizingTest, varying_sizes_reallocate_once_per_payload) {
+  PayloadSizing sizing(16, 64);
+  History history(10, 16);
+  for (uint32_t i = 0; i < 200; ++i) {
+    history.write(sizing, i % 2 ? 1000 : 100 + i);
+  }
+
+  auto stats = sizing.stats();
+  EXPECT_EQ(200u, stats.samples);
+  EXPECT_EQ(1000u, stats.reserved_size);
+  // Each payload grows once to the high water mark, the first one before the first large sample
+  EXPECT_EQ(11u, stats.reallocations);
+  // Sized exactly, payloads holding the growing small samples are reallocated on every use
+  EXPECT_EQ(105u, stats.reallocations_without_presizing);
+}
+
+TEST(PayloadSizingTest, spikes_are_forgotten) {
+  PayloadSizing sizing(16, 4);
+  History history(2, 16);
+  history.write(sizing, 5000);
+  for (uint32_t i = 0; i < 8; ++i) {
+    history.write(sizing, 50);
+  }
+  EXPECT_EQ(50u, sizing.stats().reserved_size);
+}
@@ -0,0 +1,35 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "rmw_fastrtps_shared_cpp/publish_mode.hpp"
+
+using eprosima::fastrtps::PublishModeQosPolicyKind;
+
+TEST(PublishModeTest, parse) {
+  PublishModeQosPolicyKind kind;
+  ASSERT_TRUE(rmw_fastrtps_shared_cpp::parse_publish_mode("SYNCHRONOUS", kind));
+  EXPECT_EQ(eprosima::fastrtps::SYNCHRONOUS_PUBLISH_MODE, kind);
+  ASSERT_TRUE(rmw_fastrtps_shared_cpp::parse_publish_mode("ASYNCHRONOUS", kind));
+  EXPECT_EQ(eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE, kind);
+  EXPECT_FALSE(rmw_fastrtps_shared_cpp::parse_publish_mode("SYNC", kind));
+  EXPECT_FALSE(rmw_fastrtps_shared_cpp::parse_publish_mode("", kind));
+}
+
+TEST(PublishModeTest, asynchronous_by_default) {
+  EXPECT_EQ(
+    eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE,
+    rmw_fastrtps_shared_cpp::get_publish_mode("/publish_mode_test"));
+}
@@ -0,0 +1,111 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "fastrtps/rtps/common/SerializedPayload.h"
+
+#include "rcutils/allocator.h"
+
+#include "rmw/serialized_message.h"
+
+#include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
+
+using eprosima::fastrtps::rtps::SerializedPayload_t;
+
+// Serialized messages never reach the ROS message callbacks
+class RawTypeSupport : public rmw_fastrtps_shared_cpp::TypeSupport
+{
+public:
+  size_t getEstimatedSerializedSize(const void *, const void *) const override
+  {
+    return 0;
+  }
+
+  bool serializeROSmessage(const void *, eprosima::fastcdr::Cdr &, const void *) const override
+  {
+    return false;
+  }
+
+  bool deserializeROSmessage(eprosima::fastcdr::Cdr &, void *, const void *) const override
+  {
+    return false;
+  }
+};
+
+class SerializedPayloadTest : public ::testing::Test
+{
+public:
+  void SetUp() override
+  {
+    message = rmw_get_zero_initialized_serialized_message();
+    ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&message, 16, &allocator));
+  }
+
+  void TearDown() override
+  {
+    EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&message));
+  }
+
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rmw_serialized_message_t message;
+  RawTypeSupport type_support;
+};
+
+TEST_F(SerializedPayloadTest, round_trip_through_the_payload) {
+  const size_t size = 100000;
+  ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_resize(&message, size));
+  for (size_t i = 0; i < size; ++i) {
+    message.buffer[i] = static_cast<uint8_t>(i * 7);
+  }
+  message.buffer_length = size;
+
+  rmw_fastrtps_shared_cpp::SerializedData data;
+  data.is_cdr_buffer = true;
+  data.data = nullptr;
+  data.impl = nullptr;
+  data.serialized_message = &message;
+  EXPECT_EQ(size, type_support.getSerializedSizeProvider(&data)());
+
+  SerializedPayload_t payload(static_cast<uint32_t>(size));
+  ASSERT_TRUE(type_support.serialize(&data, &payload));
+  ASSERT_EQ(size, payload.length);
+  EXPECT_EQ(0, memcmp(message.buffer, payload.data, size));
+
+  // Grown from its initial capacity on take
+  rmw_serialized_message_t taken = rmw_get_zero_initialized_serialized_message();
+  ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&taken, 16, &allocator));
+  data.serialized_message = &taken;
+  ASSERT_TRUE(type_support.deserialize(&payload, &data));
+  ASSERT_EQ(size, taken.buffer_length);
+  EXPECT_LE(size, taken.buffer_capacity);
+  EXPECT_EQ(0, memcmp(message.buffer, taken.buffer, size));
+  EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&taken));
+}
+
+TEST_F(SerializedPayloadTest, payload_too_small) {
+  ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_resize(&message, 64));
+  memset(message.buffer, 1, 64);
+  message.buffer_length = 64;
+
+  rmw_fastrtps_shared_cpp::SerializedData data;
+  data.is_cdr_buffer = true;
+  data.data = nullptr;
+  data.impl = nullptr;
+  data.serialized_message = &message;
+  SerializedPayload_t payload(32);
+  EXPECT_FALSE(type_support.serialize(&data, &payload));
+}
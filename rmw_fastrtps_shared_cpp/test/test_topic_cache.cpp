@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <tuple>
@@ -32,6 +33,13 @@ using eprosima::fastrtps::rtps::GUID_t;
 using eprosima::fastrtps::rtps::GuidPrefix_t;
 using eprosima::fastrtps::rtps::InstanceHandle_t;
 
+static bool has_topic_type(const std::vector<TopicData> & topic_data, const std::string & type)
+{
+  return std::find_if(
+    topic_data.begin(), topic_data.end(),
+    [&type](const TopicData & data) {return data.topic_type == type;}) != topic_data.end();
+}
+
 class TopicCacheTestFixture : public ::testing::Test
 {
 public:
@@ -139,12 +147,12 @@ TEST_F(TopicCacheTestFixture, test_topic_cache_get_participant_map)
   const auto & topic1it = topic_type_map.find("topic1");
   ASSERT_TRUE(topic1it != topic_type_map.end());
   auto topic_types = topic1it->second;
-  EXPECT_TRUE(std::find(topic_types.begin(), topic_types.end(), "type1") != topic_types.end());
+  EXPECT_TRUE(has_topic_type(topic_types, "type1"));
 
   const auto & topic2it = topic_type_map.find("topic2");
   ASSERT_TRUE(topic2it != topic_type_map.end());
   topic_types = topic2it->second;
-  EXPECT_TRUE(std::find(topic_types.begin(), topic_types.end(), "type2") != topic_types.end());
+  EXPECT_TRUE(has_topic_type(topic_types, "type2"));
 
   // participant 2
   const auto & it2 = participant_topic_map.find(this->participant_guid[1]);
@@ -155,22 +163,26 @@ TEST_F(TopicCacheTestFixture, test_topic_cache_get_participant_map)
   const auto & topic1it2 = topic_type_map2.find("topic1");
   ASSERT_TRUE(topic1it2 != topic_type_map2.end());
   topic_types = topic1it2->second;
-  EXPECT_TRUE(std::find(topic_types.begin(), topic_types.end(), "type1") != topic_types.end());
+  EXPECT_TRUE(has_topic_type(topic_types, "type1"));
 
   const auto & topic2it2 = topic_type_map2.find("topic2");
   ASSERT_TRUE(topic2it2 != topic_type_map2.end());
   topic_types = topic2it2->second;
-  EXPECT_TRUE(std::find(topic_types.begin(), topic_types.end(), "type1") != topic_types.end());
+  EXPECT_TRUE(has_topic_type(topic_types, "type1"));
 }
 
 TEST_F(TopicCacheTestFixture, test_topic_cache_get_topic_name_topic_data_map)
 {
   const auto & topic_data_map = this->topic_cache.getTopicNameToTopicData();
   auto expected_results = std::map<std::string, std::vector<TopicData>>();
-  expected_results["topic1"].push_back({participant_guid[0], guid[0], "type1", rmw_qos[0]});
-  expected_results["topic1"].push_back({participant_guid[1], guid[1], "type1", rmw_qos[1]});
-  expected_results["topic2"].push_back({participant_guid[0], guid[0], "type2", rmw_qos[0]});
-  expected_results["topic2"].push_back({participant_guid[1], guid[1], "type1", rmw_qos[1]});
+  expected_results["topic1"].push_back(
+    {participant_guid[0], guid[0], "type1", rmw_qos[0], TopicKind::Other, "", ""});
+  expected_results["topic1"].push_back(
+    {participant_guid[1], guid[1], "type1", rmw_qos[1], TopicKind::Other, "", ""});
+  expected_results["topic2"].push_back(
+    {participant_guid[0], guid[0], "type2", rmw_qos[0], TopicKind::Other, "", ""});
+  expected_results["topic2"].push_back(
+    {participant_guid[1], guid[1], "type1", rmw_qos[1], TopicKind::Other, "", ""});
   for (const auto & result_it : expected_results) {
     const auto & topic_name = result_it.first;
     const auto & expected_topic_data = result_it.second;
@@ -260,3 +272,44 @@ TEST_F(TopicCacheTestFixture, test_topic_cache_remove_policy_element_does_not_ex
     this->participant_instance_handler[1], this->guid[1], "NewTestTopic", "TestType");
   ASSERT_FALSE(did_remove);
 }
+
+TEST_F(TopicCacheTestFixture, test_topic_cache_demangled_topic_data)
+{
+  this->topic_cache.addTopic(
+    this->participant_instance_handler[0], this->guid[0], "rt/chatter",
+    "std_msgs::msg::dds_::String_", this->qos[0]);
+  this->topic_cache.addTopic(
+    this->participant_instance_handler[0], this->guid[0], "rq/add_two_intsRequest",
+    "example_interfaces::srv::dds_::AddTwoInts_Request_", this->qos[0]);
+  this->topic_cache.addTopic(
+    this->participant_instance_handler[0], this->guid[0], "rr/add_two_intsReply",
+    "example_interfaces::srv::dds_::AddTwoInts_Response_", this->qos[0]);
+
+  const auto & topic_data_map = this->topic_cache.getTopicNameToTopicData();
+
+  const auto & topic_it = topic_data_map.find("rt/chatter");
+  ASSERT_TRUE(topic_it != topic_data_map.end());
+  ASSERT_EQ(topic_it->second.size(), 1u);
+  EXPECT_EQ(topic_it->second.at(0).kind, TopicKind::Topic);
+  EXPECT_EQ(topic_it->second.at(0).ros_name, "/chatter");
+  EXPECT_EQ(topic_it->second.at(0).ros_type, "std_msgs/msg/String");
+
+  const auto & request_it = topic_data_map.find("rq/add_two_intsRequest");
+  ASSERT_TRUE(request_it != topic_data_map.end());
+  ASSERT_EQ(request_it->second.size(), 1u);
+  EXPECT_EQ(request_it->second.at(0).kind, TopicKind::Request);
+  EXPECT_EQ(request_it->second.at(0).ros_name, "/add_two_ints");
+  EXPECT_EQ(request_it->second.at(0).ros_type, "example_interfaces/srv/AddTwoInts");
+
+  const auto & reply_it = topic_data_map.find("rr/add_two_intsReply");
+  ASSERT_TRUE(reply_it != topic_data_map.end());
+  ASSERT_EQ(reply_it->second.size(), 1u);
+  EXPECT_EQ(reply_it->second.at(0).kind, TopicKind::Reply);
+  EXPECT_EQ(reply_it->second.at(0).ros_name, "/add_two_ints");
+  EXPECT_EQ(reply_it->second.at(0).ros_type, "example_interfaces/srv/AddTwoInts");
+
+  const auto & other_it = topic_data_map.find("topic1");
+  ASSERT_TRUE(other_it != topic_data_map.end());
+  EXPECT_EQ(other_it->second.at(0).kind, TopicKind::Other);
+  EXPECT_EQ(other_it->second.at(0).ros_name, "topic1");
+}